@@ -0,0 +1,88 @@
+// Arena used by Pack()/Unpack() when the generator runs with the arena option.
+//
+// Every thread owns one google::protobuf::Arena whose first block is kept for
+// the lifetime of the thread. An FArenaScope hands that arena out and Reset()s
+// it on exit, so a whole request or response is bump-allocated from memory
+// that was already there and nothing is returned to the global allocator.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <memory>
+#include <google/protobuf/arena.h>
+
+#ifndef PROTOUE_ARENA_BLOCK_SIZE
+#define PROTOUE_ARENA_BLOCK_SIZE (64 * 1024)
+#endif
+
+namespace ProtoUE
+{
+	namespace Private
+	{
+		struct FThreadArena
+		{
+			FThreadArena()
+				: InitialBlock(new char[PROTOUE_ARENA_BLOCK_SIZE])
+				, Arena(MakeOptions(InitialBlock.get()))
+				, Depth(0)
+			{
+			}
+
+			static google::protobuf::ArenaOptions MakeOptions(char* Block)
+			{
+				google::protobuf::ArenaOptions Options;
+				Options.initial_block = Block;
+				Options.initial_block_size = PROTOUE_ARENA_BLOCK_SIZE;
+				Options.start_block_size = PROTOUE_ARENA_BLOCK_SIZE;
+				return Options;
+			}
+
+			static FThreadArena& Get()
+			{
+				static thread_local FThreadArena ThreadArena;
+				return ThreadArena;
+			}
+
+			// Declared before Arena so it outlives it.
+			std::unique_ptr<char[]> InitialBlock;
+			google::protobuf::Arena Arena;
+			int32 Depth;
+		};
+	}
+
+	class FArenaScope
+	{
+	public:
+		FArenaScope()
+			: ThreadArena(Private::FThreadArena::Get())
+		{
+			// A nested scope (e.g. a Pack() issued while converting) must not
+			// reset memory the outer scope still uses.
+			if (ThreadArena.Depth++ > 0)
+			{
+				NestedArena.reset(new google::protobuf::Arena());
+			}
+		}
+
+		~FArenaScope()
+		{
+			if (--ThreadArena.Depth == 0)
+			{
+				ThreadArena.Arena.Reset();
+			}
+		}
+
+		google::protobuf::Arena* Get() const
+		{
+			return NestedArena ? NestedArena.get() : &ThreadArena.Arena;
+		}
+
+	private:
+		Private::FThreadArena& ThreadArena;
+		std::unique_ptr<google::protobuf::Arena> NestedArena;
+
+		FArenaScope(const FArenaScope&) = delete;
+		FArenaScope& operator=(const FArenaScope&) = delete;
+	};
+}
@@ -0,0 +1,133 @@
+// Request batching used with the batch_requests generator option.
+//
+// A batch packs several requests back to back into one payload, so a burst
+// pays for one frame and one send. The envelope is plain protobuf wire
+// format, the server can decode it with
+//
+//   message Batch      { repeated BatchEntry entries = 1; }
+//   message BatchEntry { int32 cmd = 1; bytes payload = 2; }
+//
+// and answers with the same layout, which ForEachBatchEntry() splits back
+// into (Cmd, payload) pairs for UResponse::Unpack(const uint8*, int32).
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "ProtoUEWire.h"
+
+namespace ProtoUE
+{
+	class FRequestBatch
+	{
+	public:
+		// RequestType is a generated U*Req; its payload is appended with the
+		// generated AppendPayload(), as Pack() would have produced it.
+		template <typename RequestType>
+		void Add(RequestType& Request)
+		{
+			Scratch.Reset();
+			Request.AppendPayload(Scratch);
+			Add(static_cast<int32>(Request.GetCmd()), Scratch.GetData(), Scratch.Num());
+		}
+
+		void Add(int32 Cmd, const uint8* Payload, int32 Size)
+		{
+			const uint32 EntrySize = 1 + WireFormatLite::Int32Size(Cmd)
+				+ 1 + CodedOutputStream::VarintSize32(static_cast<uint32>(Size)) + Size;
+			const int32 Offset = Bytes.AddUninitialized(1 + CodedOutputStream::VarintSize32(EntrySize) + EntrySize);
+
+			uint8* Target = Bytes.GetData() + Offset;
+			Target = WireFormatLite::WriteTagToArray(1, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+			Target = CodedOutputStream::WriteVarint32ToArray(EntrySize, Target);
+			Target = WireFormatLite::WriteInt32ToArray(1, Cmd, Target);
+			Target = WireFormatLite::WriteTagToArray(2, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+			Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(Size), Target);
+			FMemory::Memcpy(Target, Payload, Size);
+			++Count;
+		}
+
+		int32 Num() const
+		{
+			return Count;
+		}
+
+		// The envelope to send under the game's batch command.
+		const TArray<uint8>& GetBytes() const
+		{
+			return Bytes;
+		}
+
+		// Empties the batch, keeping its buffers for the next burst.
+		void Reset()
+		{
+			Bytes.Reset();
+			Count = 0;
+		}
+
+	private:
+		TArray<uint8> Bytes;
+		TArray<uint8> Scratch;
+		int32 Count = 0;
+	};
+
+	// Calls Handler(Cmd, Payload, PayloadSize) for every entry of a batch
+	// envelope, in order. Payload points into Bytes, nothing is copied.
+	// Returns false on malformed input; entries before the error were handled.
+	inline bool ForEachBatchEntry(const uint8* Bytes, int32 Size, TFunctionRef<void(int32 Cmd, const uint8* Payload, int32 PayloadSize)> Handler)
+	{
+		CodedInputStream Input(Bytes, Size);
+		for (uint32 Tag = Input.ReadTag(); Tag != 0; Tag = Input.ReadTag())
+		{
+			if (Tag != WireFormatLite::MakeTag(1, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+			{
+				if (!WireFormatLite::SkipField(&Input, Tag))
+				{
+					return false;
+				}
+				continue;
+			}
+
+			int Length;
+			if (!Input.ReadVarintSizeAsInt(&Length))
+			{
+				return false;
+			}
+			const CodedInputStream::Limit Limit = Input.PushLimit(Length);
+			int32 Cmd = 0;
+			const void* Payload = nullptr;
+			int PayloadSize = 0;
+			for (uint32 EntryTag = Input.ReadTag(); EntryTag != 0; EntryTag = Input.ReadTag())
+			{
+				bool bRead;
+				if (EntryTag == WireFormatLite::MakeTag(1, WireFormatLite::WIRETYPE_VARINT))
+				{
+					bRead = ReadScalar< ::google::protobuf::int32, WireFormatLite::TYPE_INT32>(&Input, Cmd);
+				}
+				else if (EntryTag == WireFormatLite::MakeTag(2, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+				{
+					// The whole envelope is one array, so the payload is contiguous.
+					int Available;
+					bRead = Input.ReadVarintSizeAsInt(&PayloadSize) && (PayloadSize == 0 ||
+						(Input.GetDirectBufferPointer(&Payload, &Available) && Available >= PayloadSize &&
+						Input.Skip(PayloadSize)));
+				}
+				else
+				{
+					bRead = WireFormatLite::SkipField(&Input, EntryTag);
+				}
+				if (!bRead)
+				{
+					return false;
+				}
+			}
+			if (!Input.ConsumedEntireMessage())
+			{
+				return false;
+			}
+			Input.PopLimit(Limit);
+			Handler(Cmd, static_cast<const uint8*>(Payload), PayloadSize);
+		}
+		return Input.ConsumedEntireMessage();
+	}
+}
@@ -0,0 +1,71 @@
+// Conversion between protobuf bytes fields (std::string) and the
+// TArray<uint8> / TArrayView<const uint8> members the generator emits for
+// them. The payload is copied as is, never transcoded.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <google/protobuf/repeated_field.h>
+
+namespace ProtoUE
+{
+	// Replaces Out with the bytes of Src.
+	template <typename AllocatorType>
+	void StringToBytes(const char* Src, int32 Len, TArray<uint8, AllocatorType>& Out)
+	{
+		Out.SetNumUninitialized(Len, false);
+		if (Len > 0)
+		{
+			FMemory::Memcpy(Out.GetData(), Src, Len);
+		}
+	}
+
+	template <typename AllocatorType>
+	void StringToBytes(const std::string& Src, TArray<uint8, AllocatorType>& Out)
+	{
+		StringToBytes(Src.data(), static_cast<int32>(Src.size()), Out);
+	}
+
+	// Replaces *Out with the bytes of Src.
+	template <typename AllocatorType>
+	void BytesToString(const TArray<uint8, AllocatorType>& Src, std::string* Out)
+	{
+		Out->assign(reinterpret_cast<const char*>(Src.GetData()), Src.Num());
+	}
+
+	inline void BytesToString(const TArrayView<const uint8>& Src, std::string* Out)
+	{
+		Out->assign(reinterpret_cast<const char*>(Src.GetData()), Src.Num());
+	}
+
+	// Non-owning view of Src, valid as long as Src is neither changed nor
+	// destroyed.
+	inline TArrayView<const uint8> BytesView(const std::string& Src)
+	{
+		return TArrayView<const uint8>(reinterpret_cast<const uint8*>(Src.data()), static_cast<int32>(Src.size()));
+	}
+
+	// Appends every element of Src to Out.
+	template <typename AllocatorType>
+	void StringArrayToBytes(const google::protobuf::RepeatedPtrField<std::string>& Src, TArray<TArray<uint8>, AllocatorType>& Out)
+	{
+		int32 Index = Out.AddDefaulted(Src.size());
+		for (const std::string& Element : Src)
+		{
+			StringToBytes(Element, Out[Index++]);
+		}
+	}
+
+	// Appends every element of Src to *Out.
+	template <typename AllocatorType>
+	void BytesArrayToString(const TArray<TArray<uint8>, AllocatorType>& Src, google::protobuf::RepeatedPtrField<std::string>* Out)
+	{
+		Out->Reserve(Out->size() + Src.Num());
+		for (const TArray<uint8>& Element : Src)
+		{
+			BytesToString(Element, Out->Add());
+		}
+	}
+}
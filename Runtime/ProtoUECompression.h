@@ -0,0 +1,293 @@
+// Payload compression used by the compress generator option and the
+// "compress" message annotation.
+//
+// The codec is a self-contained implementation of the LZ4 block format
+// (greedy matching, 64 KB window), so it needs no third-party library and
+// its output can be decoded by any LZ4 block decoder on the server.
+//
+// A compressed payload is framed as
+//
+//   0x00  varint32 uncompressed size  LZ4 block
+//
+// A serialized protobuf message never starts with a 0x00 byte (field number
+// 0 is invalid), so compressed and plain payloads can be told apart without a
+// flag from the transport, and a peer that does not compress keeps working.
+//
+// Decoding is whole-block, not streaming: Unpack() is only called with a
+// complete frame, and the decoded payload has to be contiguous anyway, since
+// MergeFromWire, the "view" fields and the FString transcoding read straight
+// from one buffer. The block is decoded in a single pass into a per-thread
+// buffer that keeps its allocation, so a large response costs one pass over
+// its bytes and no allocation once the buffer has grown.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <google/protobuf/io/coded_stream.h>
+
+namespace ProtoUE
+{
+	// Same names as in ProtoUEWire.h; only the varint helpers are needed, so
+	// the codec also builds on its own (see bench/compression_bench.cc).
+	typedef ::google::protobuf::io::CodedOutputStream CodedOutputStream;
+	typedef ::google::protobuf::io::CodedInputStream CodedInputStream;
+
+	namespace LZ4
+	{
+		enum
+		{
+			MinMatch = 4,
+			// The last 5 bytes are always literals and the last match starts at
+			// least 12 bytes before the end, as the format requires.
+			LastLiterals = 5,
+			MatchFindLimit = 12,
+			MaxOffset = 65535,
+			HashLog = 12,
+		};
+
+		// Worst case output size for SrcSize input bytes.
+		FORCEINLINE int32 CompressBound(int32 SrcSize)
+		{
+			return SrcSize + SrcSize / 255 + 16;
+		}
+
+		FORCEINLINE uint32 Read32(const uint8* Ptr)
+		{
+			uint32 Value;
+			FMemory::Memcpy(&Value, Ptr, sizeof(Value));
+			return Value;
+		}
+
+		FORCEINLINE uint32 Hash(uint32 Sequence)
+		{
+			return (Sequence * 2654435761u) >> (32 - HashLog);
+		}
+
+		FORCEINLINE uint8* WriteLength(uint32 Length, uint8* Target)
+		{
+			for (; Length >= 255; Length -= 255)
+			{
+				*Target++ = 255;
+			}
+			*Target++ = static_cast<uint8>(Length);
+			return Target;
+		}
+
+		FORCEINLINE uint8* WriteSequence(const uint8* Literals, uint32 LiteralLength, uint32 Offset, uint32 MatchLength, uint8* Target)
+		{
+			uint8* Token = Target++;
+			*Token = static_cast<uint8>(FMath::Min<uint32>(LiteralLength, 15) << 4);
+			if (LiteralLength >= 15)
+			{
+				Target = WriteLength(LiteralLength - 15, Target);
+			}
+			FMemory::Memcpy(Target, Literals, LiteralLength);
+			Target += LiteralLength;
+			if (MatchLength == 0)
+			{
+				return Target;
+			}
+
+			*Target++ = static_cast<uint8>(Offset);
+			*Target++ = static_cast<uint8>(Offset >> 8);
+			const uint32 ExtraMatch = MatchLength - MinMatch;
+			*Token |= static_cast<uint8>(FMath::Min<uint32>(ExtraMatch, 15));
+			if (ExtraMatch >= 15)
+			{
+				Target = WriteLength(ExtraMatch - 15, Target);
+			}
+			return Target;
+		}
+
+		// Compresses Src into Dst, which must hold CompressBound(SrcSize) bytes.
+		// Returns the compressed size.
+		inline int32 Compress(const uint8* Src, int32 SrcSize, uint8* Dst)
+		{
+			uint8* Target = Dst;
+			int32 Anchor = 0;
+			if (SrcSize > MatchFindLimit)
+			{
+				int32 Table[1 << HashLog];
+				FMemory::Memset(Table, 0xFF, sizeof(Table));
+
+				const int32 Limit = SrcSize - MatchFindLimit;
+				const int32 MatchLimit = SrcSize - LastLiterals;
+				int32 Pos = 0;
+				while (Pos < Limit)
+				{
+					const uint32 Sequence = Read32(Src + Pos);
+					const uint32 Slot = Hash(Sequence);
+					const int32 Ref = Table[Slot];
+					Table[Slot] = Pos;
+					if (Ref < 0 || Pos - Ref > MaxOffset || Read32(Src + Ref) != Sequence)
+					{
+						++Pos;
+						continue;
+					}
+
+					int32 Length = MinMatch;
+					while (Pos + Length < MatchLimit && Src[Ref + Length] == Src[Pos + Length])
+					{
+						++Length;
+					}
+					Target = WriteSequence(Src + Anchor, Pos - Anchor, Pos - Ref, Length, Target);
+					Pos += Length;
+					Anchor = Pos;
+				}
+			}
+			Target = WriteSequence(Src + Anchor, SrcSize - Anchor, 0, 0, Target);
+			return static_cast<int32>(Target - Dst);
+		}
+
+		// Decodes one block into exactly DstSize bytes in a single pass, writing
+		// straight into the destination. Returns false on malformed input, it
+		// never reads or writes out of bounds.
+		inline bool Decompress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstSize)
+		{
+			const uint8* Input = Src;
+			const uint8* const InputEnd = Src + SrcSize;
+			uint8* Output = Dst;
+			uint8* const OutputEnd = Dst + DstSize;
+
+			while (Input < InputEnd)
+			{
+				const uint32 Token = *Input++;
+
+				size_t LiteralLength = Token >> 4;
+				if (LiteralLength == 15)
+				{
+					uint8 Byte;
+					do
+					{
+						if (Input >= InputEnd)
+						{
+							return false;
+						}
+						Byte = *Input++;
+						LiteralLength += Byte;
+					} while (Byte == 255);
+				}
+				if (LiteralLength > static_cast<size_t>(InputEnd - Input) || LiteralLength > static_cast<size_t>(OutputEnd - Output))
+				{
+					return false;
+				}
+				FMemory::Memcpy(Output, Input, LiteralLength);
+				Input += LiteralLength;
+				Output += LiteralLength;
+				if (Input == InputEnd)
+				{
+					// The last sequence has no match.
+					break;
+				}
+
+				if (InputEnd - Input < 2)
+				{
+					return false;
+				}
+				const size_t Offset = Input[0] | (Input[1] << 8);
+				Input += 2;
+				if (Offset == 0 || Offset > static_cast<size_t>(Output - Dst))
+				{
+					return false;
+				}
+
+				size_t MatchLength = Token & 15;
+				if (MatchLength == 15)
+				{
+					uint8 Byte;
+					do
+					{
+						if (Input >= InputEnd)
+						{
+							return false;
+						}
+						Byte = *Input++;
+						MatchLength += Byte;
+					} while (Byte == 255);
+				}
+				MatchLength += MinMatch;
+				if (MatchLength > static_cast<size_t>(OutputEnd - Output))
+				{
+					return false;
+				}
+
+				const uint8* Match = Output - Offset;
+				if (Offset >= MatchLength)
+				{
+					FMemory::Memcpy(Output, Match, MatchLength);
+					Output += MatchLength;
+				}
+				else
+				{
+					// Overlapping copy repeats the last Offset bytes.
+					for (size_t Index = 0; Index < MatchLength; ++Index)
+					{
+						*Output++ = Match[Index];
+					}
+				}
+			}
+			return Output == OutputEnd;
+		}
+	}
+
+	// Replaces Data/Size with the framed compressed payload when Size is at
+	// least Threshold and compression saves space; otherwise leaves them
+	// alone. The compressed bytes live in a per-thread buffer that is reused
+	// by the next call on the thread.
+	inline void CompressPayload(const uint8*& Data, int32& Size, int32 Threshold)
+	{
+		if (Threshold <= 0 || Size < Threshold)
+		{
+			return;
+		}
+
+		static thread_local TArray<uint8> Buffer;
+		const int32 HeaderSize = 1 + CodedOutputStream::VarintSize32(static_cast<uint32>(Size));
+		Buffer.SetNumUninitialized(HeaderSize + LZ4::CompressBound(Size), false);
+		uint8* Target = Buffer.GetData();
+		*Target++ = 0;
+		Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(Size), Target);
+		const int32 CompressedSize = HeaderSize + LZ4::Compress(Data, Size, Target);
+		if (CompressedSize < Size)
+		{
+			Data = Buffer.GetData();
+			Size = CompressedSize;
+		}
+	}
+
+	// Undoes CompressPayload(): a framed payload is decoded into a per-thread
+	// buffer and Bytes/Size are pointed at it, a plain payload is left alone.
+	// Returns false for a corrupt frame.
+	inline bool DecompressPayload(const uint8*& Bytes, int32& Size)
+	{
+		if (Size == 0 || Bytes[0] != 0)
+		{
+			return true;
+		}
+
+		CodedInputStream Input(Bytes + 1, Size - 1);
+		uint32 RawSize;
+		if (!Input.ReadVarint32(&RawSize) || RawSize > static_cast<uint32>(MAX_int32))
+		{
+			return false;
+		}
+		const int32 HeaderSize = 1 + Input.CurrentPosition();
+		// One LZ4 input byte expands to at most 255 output bytes, a larger
+		// claimed size is corrupt and must not be allocated.
+		if (static_cast<uint64>(RawSize) > static_cast<uint64>(Size - HeaderSize) * 255)
+		{
+			return false;
+		}
+
+		static thread_local TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(static_cast<int32>(RawSize), false);
+		if (!LZ4::Decompress(Bytes + HeaderSize, Size - HeaderSize, Buffer.GetData(), Buffer.Num()))
+		{
+			return false;
+		}
+		Bytes = Buffer.GetData();
+		Size = Buffer.Num();
+		return true;
+	}
+}
@@ -0,0 +1,182 @@
+// String field that keeps the UTF-8 bytes of the parsed message and only
+// builds the FString the first time it is read.
+//
+// Generated for string fields annotated with "lazy" and, with the
+// lazy_strings generator option, for every string field of a Resp/Push.
+//
+// Get() may be called from several threads at once on a shared payload
+// (shared_payload, two_phase_unpack): the first conversion runs under a lock
+// and is published through an atomic flag, later calls only read it. The
+// setters are writes and need exclusive access like any other member.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Misc/ScopeLock.h"
+#include "ProtoUEString.h"
+
+#include <atomic>
+#include <string>
+
+#include "ProtoUELazyString.generated.h"
+
+namespace ProtoUE
+{
+	namespace Private
+	{
+		// Only taken by the first Get() of a value, so one lock for all of them
+		// is enough.
+		FORCEINLINE FCriticalSection& LazyStringLock()
+		{
+			static FCriticalSection Lock;
+			return Lock;
+		}
+	}
+}
+
+USTRUCT(BlueprintType)
+struct FProtoLazyString
+{
+	GENERATED_USTRUCT_BODY()
+
+	FProtoLazyString()
+		: bMaterialized(true)
+	{
+	}
+
+	FProtoLazyString(const FProtoLazyString& Other)
+		: Utf8(Other.Utf8)
+		, bMaterialized(false)
+	{
+		CopyValue(Other);
+	}
+
+	FProtoLazyString& operator=(const FProtoLazyString& Other)
+	{
+		if (this != &Other)
+		{
+			Utf8 = Other.Utf8;
+			CopyValue(Other);
+		}
+		return *this;
+	}
+
+	// Moving writes Other, so nothing converts it concurrently.
+	FProtoLazyString(FProtoLazyString&& Other)
+		: Utf8(MoveTemp(Other.Utf8))
+		, Value(MoveTemp(Other.Value))
+		, bMaterialized(Other.bMaterialized.load(std::memory_order_relaxed))
+	{
+		Other.Reset();
+	}
+
+	FProtoLazyString& operator=(FProtoLazyString&& Other)
+	{
+		if (this != &Other)
+		{
+			Utf8 = MoveTemp(Other.Utf8);
+			Value = MoveTemp(Other.Value);
+			bMaterialized.store(Other.bMaterialized.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			Other.Reset();
+		}
+		return *this;
+	}
+
+	void SetUtf8(const std::string& InUtf8)
+	{
+		Utf8 = InUtf8;
+		Invalidate();
+	}
+
+	void SetUtf8(std::string&& InUtf8)
+	{
+		Utf8 = MoveTemp(InUtf8);
+		Invalidate();
+	}
+
+	void Set(const FString& InValue)
+	{
+		Value = InValue;
+		bMaterialized.store(true, std::memory_order_relaxed);
+		ProtoUE::FStringToUtf8(Value, &Utf8);
+	}
+
+	const std::string& GetUtf8() const
+	{
+		return Utf8;
+	}
+
+	const FString& Get() const
+	{
+		if (!bMaterialized.load(std::memory_order_acquire))
+		{
+			FScopeLock Lock(&ProtoUE::Private::LazyStringLock());
+			if (!bMaterialized.load(std::memory_order_relaxed))
+			{
+				ProtoUE::Utf8ToFString(Utf8, Value);
+				bMaterialized.store(true, std::memory_order_release);
+			}
+		}
+		return Value;
+	}
+
+	bool IsEmpty() const
+	{
+		return Utf8.empty();
+	}
+
+	void Reset()
+	{
+		Utf8.clear();
+		Value.Reset();
+		bMaterialized.store(true, std::memory_order_relaxed);
+	}
+
+private:
+	void Invalidate()
+	{
+		bMaterialized.store(Utf8.empty(), std::memory_order_relaxed);
+		Value.Reset();
+	}
+
+	// Other may be converting on another thread; its Value is only read once
+	// the flag says it is complete.
+	void CopyValue(const FProtoLazyString& Other)
+	{
+		if (Other.bMaterialized.load(std::memory_order_acquire))
+		{
+			Value = Other.Value;
+			bMaterialized.store(true, std::memory_order_relaxed);
+		}
+		else
+		{
+			Value.Reset();
+			bMaterialized.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	std::string Utf8;
+	mutable FString Value;
+	mutable std::atomic<bool> bMaterialized;
+};
+
+UCLASS()
+class PROJECT_X_API UProtoLazyStringLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	// Converts the stored bytes on the first call and returns the cached value afterwards.
+	UFUNCTION(BlueprintPure, Category = "Proto", Meta = (DisplayName = "Get String", CompactNodeTitle = "->"))
+	static FString GetLazyString(const FProtoLazyString& LazyString)
+	{
+		return LazyString.Get();
+	}
+
+	UFUNCTION(BlueprintPure, Category = "Proto")
+	static bool IsLazyStringEmpty(const FProtoLazyString& LazyString)
+	{
+		return LazyString.IsEmpty();
+	}
+};
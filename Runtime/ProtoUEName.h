@@ -0,0 +1,130 @@
+// UTF-8 <-> FName conversion for string fields with the "fname" annotation.
+//
+// Identifiers are short and almost always ASCII, so the UTF-8 bytes are
+// copied into a NUL-terminated ANSICHAR buffer on the stack and looked up in
+// the name table directly, without building an FString first. Other text is
+// widened into a stack TCHAR buffer. Going back, the name is written into a
+// per-thread FString that keeps its allocation between calls.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProtoUEString.h"
+
+#include <string>
+#include <google/protobuf/repeated_field.h>
+
+namespace ProtoUE
+{
+	namespace Private
+	{
+		FORCEINLINE bool IsAscii(const char* Src, int32 Len)
+		{
+			for (int32 Index = 0; Index < Len; ++Index)
+			{
+				if (static_cast<uint8>(Src[Index]) >= 0x80)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Reused by FNameToUtf8 and the wire helpers, game and worker threads
+		// each get their own.
+		FORCEINLINE FString& NameBuffer()
+		{
+			static thread_local FString Buffer;
+			return Buffer;
+		}
+	}
+
+	// Sets Out to the FName for the UTF-8 text in [Src, Src + Len), NAME_None
+	// for an empty string. Returns false and leaves Out alone for text of
+	// NAME_SIZE characters or more, which FName asserts on.
+	inline bool TryUtf8ToFName(const char* Src, int32 Len, FName& Out)
+	{
+		if (Len <= 0)
+		{
+			Out = NAME_None;
+			return true;
+		}
+
+		if (Len < NAME_SIZE && Private::IsAscii(Src, Len))
+		{
+			ANSICHAR Chars[NAME_SIZE];
+			FMemory::Memcpy(Chars, Src, Len);
+			Chars[Len] = 0;
+			Out = FName(Chars);
+			return true;
+		}
+
+		if (Len < NAME_SIZE && Private::bTCharIsUtf16)
+		{
+			TCHAR Chars[NAME_SIZE];
+			const int32 Count = Private::Utf8ToUtf16(reinterpret_cast<const uint8*>(Src), Len,
+				reinterpret_cast<Private::FUtf16Unit*>(Chars));
+			Chars[Count] = 0;
+			Out = FName(Chars);
+			return true;
+		}
+
+		// Multi-byte text can still fit once decoded.
+		FString& Text = Private::NameBuffer();
+		Utf8ToFString(Src, Len, Text);
+		if (Text.Len() >= NAME_SIZE)
+		{
+			return false;
+		}
+		Out = FName(*Text);
+		return true;
+	}
+
+	// Returns the FName for the UTF-8 text in [Src, Src + Len); NAME_None for
+	// an empty string and for text too long to be a name.
+	inline FName Utf8ToFName(const char* Src, int32 Len)
+	{
+		FName Name;
+		return TryUtf8ToFName(Src, Len, Name) ? Name : FName(NAME_None);
+	}
+
+	inline FName Utf8ToFName(const std::string& Src)
+	{
+		return Utf8ToFName(Src.data(), static_cast<int32>(Src.size()));
+	}
+
+	// Replaces *Out with the UTF-8 text of Name, "" for NAME_None.
+	inline void FNameToUtf8(const FName& Name, std::string* Out)
+	{
+		if (Name.IsNone())
+		{
+			Out->clear();
+			return;
+		}
+		FString& Text = Private::NameBuffer();
+		Name.ToString(Text);
+		FStringToUtf8(Text, Out);
+	}
+
+	// Appends every element of Src to Out.
+	template <typename AllocatorType>
+	void Utf8ToFNameArray(const google::protobuf::RepeatedPtrField<std::string>& Src, TArray<FName, AllocatorType>& Out)
+	{
+		Out.Reserve(Out.Num() + Src.size());
+		for (const std::string& Element : Src)
+		{
+			Out.Emplace(Utf8ToFName(Element));
+		}
+	}
+
+	// Appends every element of Src to *Out.
+	template <typename AllocatorType>
+	void FNameArrayToUtf8(const TArray<FName, AllocatorType>& Src, google::protobuf::RepeatedPtrField<std::string>* Out)
+	{
+		Out->Reserve(Out->size() + Src.Num());
+		for (const FName& Element : Src)
+		{
+			FNameToUtf8(Element, Out->Add());
+		}
+	}
+}
@@ -0,0 +1,199 @@
+// Tagged union used for the members of a protobuf oneof.
+//
+// TOneof<A, B, C> holds at most one of its alternatives in storage sized for
+// the largest one. Alternatives are addressed by their 1-based position, like
+// the generated E*Case enums (0 is "none set"), so the same type may appear
+// more than once, as it can in a oneof.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <new>
+
+namespace ProtoUE
+{
+	namespace Private
+	{
+		template <int32 Index, typename... Types>
+		struct TOneofType;
+
+		template <typename T, typename... Rest>
+		struct TOneofType<1, T, Rest...>
+		{
+			typedef T Type;
+		};
+
+		template <int32 Index, typename T, typename... Rest>
+		struct TOneofType<Index, T, Rest...>
+		{
+			typedef typename TOneofType<Index - 1, Rest...>::Type Type;
+		};
+
+		template <typename... Types>
+		struct TOneofLayout;
+
+		template <>
+		struct TOneofLayout<>
+		{
+			enum { Size = 1, Alignment = 1 };
+		};
+
+		template <typename T, typename... Rest>
+		struct TOneofLayout<T, Rest...>
+		{
+			enum
+			{
+				Size = sizeof(T) > TOneofLayout<Rest...>::Size ? sizeof(T) : TOneofLayout<Rest...>::Size,
+				Alignment = alignof(T) > TOneofLayout<Rest...>::Alignment ? alignof(T) : TOneofLayout<Rest...>::Alignment,
+			};
+		};
+
+		// Lifetime operations on the alternative selected by a runtime case.
+		template <int32 Index, typename... Types>
+		struct TOneofOps
+		{
+			static void Destroy(int32 Case, void* Storage) {}
+			static void Copy(int32 Case, void* Dest, const void* Source) {}
+			static void Move(int32 Case, void* Dest, void* Source) {}
+		};
+
+		template <int32 Index, typename T, typename... Rest>
+		struct TOneofOps<Index, T, Rest...>
+		{
+			typedef TOneofOps<Index + 1, Rest...> FNext;
+
+			static void Destroy(int32 Case, void* Storage)
+			{
+				if (Case == Index)
+				{
+					static_cast<T*>(Storage)->~T();
+				}
+				else
+				{
+					FNext::Destroy(Case, Storage);
+				}
+			}
+
+			static void Copy(int32 Case, void* Dest, const void* Source)
+			{
+				if (Case == Index)
+				{
+					new (Dest) T(*static_cast<const T*>(Source));
+				}
+				else
+				{
+					FNext::Copy(Case, Dest, Source);
+				}
+			}
+
+			static void Move(int32 Case, void* Dest, void* Source)
+			{
+				if (Case == Index)
+				{
+					new (Dest) T(MoveTemp(*static_cast<T*>(Source)));
+				}
+				else
+				{
+					FNext::Move(Case, Dest, Source);
+				}
+			}
+		};
+	}
+
+	template <typename... Types>
+	class TOneof
+	{
+		typedef Private::TOneofOps<1, Types...> FOps;
+		typedef Private::TOneofLayout<Types...> FLayout;
+
+	public:
+		template <int32 Case>
+		using TAlternative = typename Private::TOneofType<Case, Types...>::Type;
+
+		TOneof()
+			: Case(0)
+		{
+		}
+
+		TOneof(const TOneof& Other)
+			: Case(Other.Case)
+		{
+			FOps::Copy(Case, &Storage, &Other.Storage);
+		}
+
+		TOneof(TOneof&& Other)
+			: Case(Other.Case)
+		{
+			FOps::Move(Case, &Storage, &Other.Storage);
+			Other.Reset();
+		}
+
+		~TOneof()
+		{
+			Reset();
+		}
+
+		TOneof& operator=(const TOneof& Other)
+		{
+			if (this != &Other)
+			{
+				Reset();
+				FOps::Copy(Other.Case, &Storage, &Other.Storage);
+				Case = Other.Case;
+			}
+			return *this;
+		}
+
+		TOneof& operator=(TOneof&& Other)
+		{
+			if (this != &Other)
+			{
+				Reset();
+				FOps::Move(Other.Case, &Storage, &Other.Storage);
+				Case = Other.Case;
+				Other.Reset();
+			}
+			return *this;
+		}
+
+		// 1-based position of the set alternative, 0 when none is set.
+		int32 GetCase() const
+		{
+			return Case;
+		}
+
+		void Reset()
+		{
+			FOps::Destroy(Case, &Storage);
+			Case = 0;
+		}
+
+		// Replaces the set alternative, if any, with alternative NewCase
+		// constructed from Args.
+		template <int32 NewCase, typename... ArgTypes>
+		TAlternative<NewCase>& Emplace(ArgTypes&&... Args)
+		{
+			Reset();
+			TAlternative<NewCase>* Value = new (&Storage) TAlternative<NewCase>(Forward<ArgTypes>(Args)...);
+			Case = NewCase;
+			return *Value;
+		}
+
+		template <int32 FindCase>
+		TAlternative<FindCase>* Find()
+		{
+			return Case == FindCase ? reinterpret_cast<TAlternative<FindCase>*>(&Storage) : nullptr;
+		}
+
+		template <int32 FindCase>
+		const TAlternative<FindCase>* Find() const
+		{
+			return Case == FindCase ? reinterpret_cast<const TAlternative<FindCase>*>(&Storage) : nullptr;
+		}
+
+	private:
+		TAlignedBytes<FLayout::Size, FLayout::Alignment> Storage;
+		int32 Case;
+	};
+}
@@ -0,0 +1,78 @@
+// Per-class object pool used by the generated Acquire()/Release() of the
+// object_pool generator option.
+//
+// Pooled objects are rooted for as long as the pool or a caller holds them,
+// so the GC never has to trace or collect them; Release() resets an object
+// with its generated Reset(), which keeps container capacity, and drops it
+// back to the GC only once the pool already holds PROTOUE_POOL_CAPACITY
+// objects of that class.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "UObject/Package.h"
+
+#ifndef PROTOUE_POOL_CAPACITY
+#define PROTOUE_POOL_CAPACITY 16
+#endif
+
+namespace ProtoUE
+{
+	// Game thread only, like NewObject.
+	template <typename T>
+	class TObjectPool
+	{
+	public:
+		static TObjectPool& Get()
+		{
+			static TObjectPool Pool;
+			return Pool;
+		}
+
+		T* Acquire()
+		{
+			check(IsInGameThread());
+			if (Free.Num() > 0)
+			{
+				return Free.Pop(false);
+			}
+			T* Object = NewObject<T>(GetTransientPackage());
+			Object->AddToRoot();
+			return Object;
+		}
+
+		// Every acquired object must come back here, it stays rooted until then.
+		void Release(T* Object)
+		{
+			check(IsInGameThread());
+			if (Object == nullptr)
+			{
+				return;
+			}
+			Object->Reset();
+			if (Free.Num() < PROTOUE_POOL_CAPACITY)
+			{
+				Free.Add(Object);
+			}
+			else
+			{
+				Object->RemoveFromRoot();
+			}
+		}
+
+		// Hands every idle object back to the GC, e.g. on map change.
+		void Trim()
+		{
+			check(IsInGameThread());
+			for (T* Object : Free)
+			{
+				Object->RemoveFromRoot();
+			}
+			Free.Empty();
+		}
+
+	private:
+		TArray<T*> Free;
+	};
+}
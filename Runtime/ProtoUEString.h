@@ -0,0 +1,422 @@
+// UTF-8 <-> TCHAR transcoding used by the generated FromPB/ToPB code.
+//
+// Copy this header next to APIProtocol.h in the game module. Conversions go
+// straight into the destination FString / std::string with a single
+// allocation sized from the input, and runs of ASCII are widened/narrowed 16
+// (SSE2) or 32 (AVX2) characters at a time.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <google/protobuf/repeated_field.h>
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define PROTOUE_SSE2 1
+#include <emmintrin.h>
+#else
+#define PROTOUE_SSE2 0
+#endif
+
+#if PROTOUE_SSE2 && defined(__AVX2__)
+#define PROTOUE_AVX2 1
+#include <immintrin.h>
+#else
+#define PROTOUE_AVX2 0
+#endif
+
+namespace ProtoUE
+{
+	namespace Private
+	{
+		typedef uint16 FUtf16Unit;
+
+		// The vector kernels assume TCHAR is a UTF-16 code unit.
+		static const bool bTCharIsUtf16 = sizeof(TCHAR) == sizeof(FUtf16Unit);
+
+		// Widens the leading ASCII run of Src into Dst and returns its length.
+		FORCEINLINE int32 WidenAscii(const uint8* Src, int32 Len, FUtf16Unit* Dst)
+		{
+			int32 Index = 0;
+#if PROTOUE_AVX2
+			for (; Index + 32 <= Len; Index += 32)
+			{
+				const __m256i Bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src + Index));
+				if (_mm256_movemask_epi8(Bytes) != 0)
+				{
+					break;
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + Index), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(Bytes)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + Index + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(Bytes, 1)));
+			}
+#endif
+#if PROTOUE_SSE2
+			const __m128i Zero = _mm_setzero_si128();
+			for (; Index + 16 <= Len; Index += 16)
+			{
+				const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index));
+				if (_mm_movemask_epi8(Bytes) != 0)
+				{
+					break;
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Index), _mm_unpacklo_epi8(Bytes, Zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Index + 8), _mm_unpackhi_epi8(Bytes, Zero));
+			}
+#endif
+			for (; Index < Len && Src[Index] < 0x80; ++Index)
+			{
+				Dst[Index] = Src[Index];
+			}
+			return Index;
+		}
+
+		// Narrows the leading ASCII run of Src into Dst and returns its length.
+		FORCEINLINE int32 NarrowAscii(const FUtf16Unit* Src, int32 Len, uint8* Dst)
+		{
+			int32 Index = 0;
+#if PROTOUE_AVX2
+			const __m256i HighMask256 = _mm256_set1_epi16(static_cast<short>(0xFF80));
+			for (; Index + 32 <= Len; Index += 32)
+			{
+				const __m256i A = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src + Index));
+				const __m256i B = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src + Index + 16));
+				if (!_mm256_testz_si256(_mm256_or_si256(A, B), HighMask256))
+				{
+					break;
+				}
+				// packus interleaves the 128-bit lanes, put the quadwords back in order.
+				const __m256i Packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(A, B), 0xD8);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + Index), Packed);
+			}
+#endif
+#if PROTOUE_SSE2
+			const __m128i HighMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+			const __m128i Zero = _mm_setzero_si128();
+			for (; Index + 16 <= Len; Index += 16)
+			{
+				const __m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index));
+				const __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Index + 8));
+				const __m128i High = _mm_and_si128(_mm_or_si128(A, B), HighMask);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(High, Zero)) != 0xFFFF)
+				{
+					break;
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Index), _mm_packus_epi16(A, B));
+			}
+#endif
+			for (; Index < Len && Src[Index] < 0x80; ++Index)
+			{
+				Dst[Index] = static_cast<uint8>(Src[Index]);
+			}
+			return Index;
+		}
+
+		// Decodes Len bytes of UTF-8 into Dst, which must hold at least Len
+		// units. Malformed sequences become U+FFFD. Returns the unit count.
+		inline int32 Utf8ToUtf16(const uint8* Src, int32 Len, FUtf16Unit* Dst)
+		{
+			int32 In = 0;
+			int32 Out = 0;
+			while (In < Len)
+			{
+				const int32 Run = WidenAscii(Src + In, Len - In, Dst + Out);
+				In += Run;
+				Out += Run;
+				if (In >= Len)
+				{
+					break;
+				}
+
+				const uint32 Lead = Src[In];
+				uint32 CodePoint;
+				int32 Extra;
+				if (Lead >= 0xC2 && Lead <= 0xDF)
+				{
+					CodePoint = Lead & 0x1F;
+					Extra = 1;
+				}
+				else if (Lead >= 0xE0 && Lead <= 0xEF)
+				{
+					CodePoint = Lead & 0x0F;
+					Extra = 2;
+				}
+				else if (Lead >= 0xF0 && Lead <= 0xF4)
+				{
+					CodePoint = Lead & 0x07;
+					Extra = 3;
+				}
+				else
+				{
+					Dst[Out++] = 0xFFFD;
+					++In;
+					continue;
+				}
+
+				bool bValid = In + Extra < Len;
+				for (int32 Offset = 1; bValid && Offset <= Extra; ++Offset)
+				{
+					const uint8 Continuation = Src[In + Offset];
+					bValid = (Continuation & 0xC0) == 0x80;
+					CodePoint = (CodePoint << 6) | (Continuation & 0x3F);
+				}
+				if (bValid)
+				{
+					bValid = !(Extra == 2 && CodePoint < 0x800)
+						&& !(Extra == 3 && CodePoint < 0x10000)
+						&& !(CodePoint >= 0xD800 && CodePoint <= 0xDFFF)
+						&& CodePoint <= 0x10FFFF;
+				}
+				if (!bValid)
+				{
+					Dst[Out++] = 0xFFFD;
+					++In;
+					continue;
+				}
+
+				In += Extra + 1;
+				if (CodePoint >= 0x10000)
+				{
+					CodePoint -= 0x10000;
+					Dst[Out++] = static_cast<FUtf16Unit>(0xD800 + (CodePoint >> 10));
+					Dst[Out++] = static_cast<FUtf16Unit>(0xDC00 + (CodePoint & 0x3FF));
+				}
+				else
+				{
+					Dst[Out++] = static_cast<FUtf16Unit>(CodePoint);
+				}
+			}
+			return Out;
+		}
+
+		// Encodes Len UTF-16 units into Dst, which must hold at least 3 * Len
+		// bytes. Unpaired surrogates become U+FFFD. Returns the byte count.
+		inline int32 Utf16ToUtf8(const FUtf16Unit* Src, int32 Len, uint8* Dst)
+		{
+			int32 In = 0;
+			int32 Out = 0;
+			while (In < Len)
+			{
+				const int32 Run = NarrowAscii(Src + In, Len - In, Dst + Out);
+				In += Run;
+				Out += Run;
+				if (In >= Len)
+				{
+					break;
+				}
+
+				uint32 CodePoint = Src[In++];
+				if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && In < Len && Src[In] >= 0xDC00 && Src[In] <= 0xDFFF)
+				{
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Src[In++] - 0xDC00);
+				}
+				else if (CodePoint >= 0xD800 && CodePoint <= 0xDFFF)
+				{
+					CodePoint = 0xFFFD;
+				}
+
+				if (CodePoint < 0x800)
+				{
+					Dst[Out++] = static_cast<uint8>(0xC0 | (CodePoint >> 6));
+					Dst[Out++] = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+				}
+				else if (CodePoint < 0x10000)
+				{
+					Dst[Out++] = static_cast<uint8>(0xE0 | (CodePoint >> 12));
+					Dst[Out++] = static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F));
+					Dst[Out++] = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+				}
+				else
+				{
+					Dst[Out++] = static_cast<uint8>(0xF0 | (CodePoint >> 18));
+					Dst[Out++] = static_cast<uint8>(0x80 | ((CodePoint >> 12) & 0x3F));
+					Dst[Out++] = static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F));
+					Dst[Out++] = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+				}
+			}
+			return Out;
+		}
+	}
+
+	// Replaces Out with the UTF-8 text in [Src, Src + Len).
+	inline void Utf8ToFString(const char* Src, int32 Len, FString& Out)
+	{
+		TArray<TCHAR>& Chars = Out.GetCharArray();
+		if (Len <= 0)
+		{
+			Chars.Reset();
+			return;
+		}
+
+		if (!Private::bTCharIsUtf16)
+		{
+			FUTF8ToTCHAR Converter(Src, Len);
+			Out = FString(Converter.Length(), Converter.Get());
+			return;
+		}
+
+		// A UTF-8 byte never expands to more than one UTF-16 unit.
+		Chars.SetNumUninitialized(Len + 1, false);
+		const int32 Count = Private::Utf8ToUtf16(reinterpret_cast<const uint8*>(Src), Len,
+			reinterpret_cast<Private::FUtf16Unit*>(Chars.GetData()));
+		Chars[Count] = 0;
+		Chars.SetNum(Count + 1, false);
+	}
+
+	inline void Utf8ToFString(const std::string& Src, FString& Out)
+	{
+		Utf8ToFString(Src.data(), static_cast<int32>(Src.size()), Out);
+	}
+
+	inline FString ToFString(const std::string& Src)
+	{
+		FString Result;
+		Utf8ToFString(Src, Result);
+		return Result;
+	}
+
+	// Replaces *Out with the UTF-8 encoding of Src.
+	inline void FStringToUtf8(const TCHAR* Src, int32 Len, std::string* Out)
+	{
+		if (Len <= 0)
+		{
+			Out->clear();
+			return;
+		}
+
+		if (!Private::bTCharIsUtf16)
+		{
+			FTCHARToUTF8 Converter(Src, Len);
+			Out->assign(Converter.Get(), Converter.Length());
+			return;
+		}
+
+		Out->resize(static_cast<size_t>(Len) * 3);
+		const int32 Count = Private::Utf16ToUtf8(reinterpret_cast<const Private::FUtf16Unit*>(Src), Len,
+			reinterpret_cast<uint8*>(&(*Out)[0]));
+		Out->resize(Count);
+	}
+
+	inline void FStringToUtf8(const FString& Src, std::string* Out)
+	{
+		FStringToUtf8(*Src, Src.Len(), Out);
+	}
+
+	inline std::string ToUtf8(const FString& Src)
+	{
+		std::string Result;
+		FStringToUtf8(Src, &Result);
+		return Result;
+	}
+
+	// Number of bytes FStringToUtf8/WriteUtf8 produce for Src.
+	inline int32 Utf8Length(const TCHAR* Src, int32 Len)
+	{
+		if (!Private::bTCharIsUtf16)
+		{
+			return FTCHARToUTF8_Convert::ConvertedLength(Src, Len);
+		}
+
+		const Private::FUtf16Unit* Units = reinterpret_cast<const Private::FUtf16Unit*>(Src);
+		int32 Count = 0;
+		for (int32 Index = 0; Index < Len; ++Index)
+		{
+			const uint32 Unit = Units[Index];
+			if (Unit < 0x80)
+			{
+				Count += 1;
+			}
+			else if (Unit < 0x800)
+			{
+				Count += 2;
+			}
+			else if (Unit >= 0xD800 && Unit <= 0xDBFF && Index + 1 < Len && Units[Index + 1] >= 0xDC00 && Units[Index + 1] <= 0xDFFF)
+			{
+				Count += 4;
+				++Index;
+			}
+			else
+			{
+				// Includes unpaired surrogates, which are written as U+FFFD.
+				Count += 3;
+			}
+		}
+		return Count;
+	}
+
+	inline int32 Utf8Length(const FString& Src)
+	{
+		return Utf8Length(*Src, Src.Len());
+	}
+
+	// Writes the UTF-8 encoding of Src (exactly Utf8Length(Src) bytes) to
+	// Target and returns the end of the written range.
+	inline uint8* WriteUtf8(const FString& Src, uint8* Target)
+	{
+		const int32 Len = Src.Len();
+		if (Len == 0)
+		{
+			return Target;
+		}
+
+		if (!Private::bTCharIsUtf16)
+		{
+			FTCHARToUTF8 Converter(*Src, Len);
+			FMemory::Memcpy(Target, Converter.Get(), Converter.Length());
+			return Target + Converter.Length();
+		}
+
+		return Target + Private::Utf16ToUtf8(reinterpret_cast<const Private::FUtf16Unit*>(*Src), Len, Target);
+	}
+
+	// Appends every element of Src to Out.
+	template <typename AllocatorType>
+	void Utf8ToFStringArray(const google::protobuf::RepeatedPtrField<std::string>& Src, TArray<FString, AllocatorType>& Out)
+	{
+		int32 Index = Out.AddDefaulted(Src.size());
+		for (const std::string& Element : Src)
+		{
+			Utf8ToFString(Element, Out[Index++]);
+		}
+	}
+
+	// Appends every element of Src to *Out.
+	template <typename AllocatorType>
+	void FStringArrayToUtf8(const TArray<FString, AllocatorType>& Src, google::protobuf::RepeatedPtrField<std::string>* Out)
+	{
+		Out->Reserve(Out->size() + Src.Num());
+		for (const FString& Element : Src)
+		{
+			FStringToUtf8(Element, Out->Add());
+		}
+	}
+
+	// KeyFuncs for TSet/TMap keyed by protobuf strings. FString's own hash and
+	// operator== ignore case, while protobuf keys differ by any byte.
+	struct FCaseSensitiveStringKeyFuncs : DefaultKeyFuncs<FString>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
+
+	template <typename ValueType>
+	struct TCaseSensitiveStringMapKeyFuncs : TDefaultMapHashableKeyFuncs<FString, ValueType, false>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
+}
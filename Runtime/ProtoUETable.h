@@ -0,0 +1,794 @@
+// Table-driven wire codec used with the table_driven_parsing and
+// table_driven_serialization generator options.
+//
+// Instead of unrolled per-field code every generated type gets a constant
+// FMessageTable (field number, member offset, kind, nested table) and the
+// functions below interpret it. Repeated members are reached through their
+// FScriptArray layout, TMap members through a TMapFieldCodec instantiated per
+// key/value kind, so one copy of this code serves every message.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProtoUEWire.h"
+
+#include <new>
+#include <string>
+
+namespace ProtoUE
+{
+	enum class EFieldKind : uint8
+	{
+		Int32,
+		Int64,
+		UInt32,
+		UInt64,
+		SInt32,
+		SInt64,
+		Fixed32,
+		Fixed64,
+		SFixed32,
+		SFixed64,
+		Float,
+		Double,
+		Bool,
+		// A UENUM(uint8) member.
+		Enum,
+		String,
+		LazyString,
+		Name,
+		// A TArray<uint8> member (bytes).
+		Bytes,
+		Message,
+		// Member handled by FFieldEntry::Custom (TMap).
+		Custom,
+	};
+
+	namespace EFieldFlags
+	{
+		enum Type : uint8
+		{
+			None = 0,
+			// The member is a TArray of the kind.
+			Repeated = 1 << 0,
+			Packed = 1 << 1,
+			// proto3: a singular scalar or string equal to its default is not written.
+			SkipDefault = 1 << 2,
+		};
+	}
+
+	struct FMessageTable;
+
+	struct FCustomFieldCodec
+	{
+		// Reads one length-delimited occurrence, the tag is already consumed.
+		bool (*Parse)(CodedInputStream* Input, void* Member);
+		size_t (*ByteSize)(const void* Member, int32 Number);
+		uint8* (*Write)(const void* Member, int32 Number, uint8* Target);
+	};
+
+	struct FFieldEntry
+	{
+		int32 Number;
+		uint32 Offset;
+		EFieldKind Kind;
+		uint8 Flags;
+		// Bit in the owner's DirtyBits, -1 when the field is not tracked.
+		int16 DirtyBit;
+		const FMessageTable& (*Nested)();
+		const FCustomFieldCodec* Custom;
+	};
+
+	struct FMessageTable
+	{
+		// Sorted by Number.
+		const FFieldEntry* Fields;
+		int32 NumFields;
+		int32 Size;
+		// Offset of CachedWireSize, -1 for types that are never nested.
+		int32 CachedSizeOffset;
+		// Offset of the DirtyBits array, -1 without dirty tracking.
+		int32 DirtyBitsOffset;
+		void (*Construct)(void* Object);
+		void (*Destruct)(void* Object);
+	};
+
+	template <typename T>
+	void ConstructStruct(void* Object)
+	{
+		new (Object) T();
+	}
+
+	template <typename T>
+	void DestructStruct(void* Object)
+	{
+		static_cast<T*>(Object)->~T();
+	}
+
+	bool MergeFromWire(CodedInputStream* Input, void* Object, const FMessageTable& Table);
+	size_t ComputeWireSize(const void* Object, const FMessageTable& Table);
+	uint8* SerializeWire(const void* Object, const FMessageTable& Table, uint8* Target);
+
+	namespace Private
+	{
+		FORCEINLINE WireFormatLite::WireType KindWireType(EFieldKind Kind)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Fixed32:
+			case EFieldKind::SFixed32:
+			case EFieldKind::Float:
+				return WireFormatLite::WIRETYPE_FIXED32;
+			case EFieldKind::Fixed64:
+			case EFieldKind::SFixed64:
+			case EFieldKind::Double:
+				return WireFormatLite::WIRETYPE_FIXED64;
+			case EFieldKind::String:
+			case EFieldKind::LazyString:
+			case EFieldKind::Name:
+			case EFieldKind::Bytes:
+			case EFieldKind::Message:
+			case EFieldKind::Custom:
+				return WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+			default:
+				return WireFormatLite::WIRETYPE_VARINT;
+			}
+		}
+
+		// Bytes one element of Kind takes in a UE member or TArray.
+		FORCEINLINE int32 KindStorageSize(EFieldKind Kind, const FFieldEntry& Field)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Int64:
+			case EFieldKind::UInt64:
+			case EFieldKind::SInt64:
+			case EFieldKind::Fixed64:
+			case EFieldKind::SFixed64:
+			case EFieldKind::Double:
+				return 8;
+			case EFieldKind::Bool:
+			case EFieldKind::Enum:
+				return 1;
+			case EFieldKind::String:
+				return sizeof(FString);
+			case EFieldKind::LazyString:
+				return sizeof(FProtoLazyString);
+			case EFieldKind::Name:
+				return sizeof(FName);
+			case EFieldKind::Bytes:
+				return sizeof(TArray<uint8>);
+			case EFieldKind::Message:
+				return Field.Nested().Size;
+			default:
+				return 4;
+			}
+		}
+
+		// Fixed width kinds whose TArray can be filled with a memcpy.
+		FORCEINLINE int32 KindFixedWireSize(EFieldKind Kind)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Fixed32:
+			case EFieldKind::SFixed32:
+			case EFieldKind::Float:
+				return 4;
+			case EFieldKind::Fixed64:
+			case EFieldKind::SFixed64:
+			case EFieldKind::Double:
+				return 8;
+			default:
+				return 0;
+			}
+		}
+
+		inline bool ReadValue(CodedInputStream* Input, EFieldKind Kind, const FFieldEntry& Field, void* Value)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Int32:
+				return ReadScalar< ::google::protobuf::int32, WireFormatLite::TYPE_INT32>(Input, *static_cast<int32*>(Value));
+			case EFieldKind::Int64:
+				return ReadScalar< ::google::protobuf::int64, WireFormatLite::TYPE_INT64>(Input, *static_cast<int64*>(Value));
+			case EFieldKind::UInt32:
+				return ReadScalar< ::google::protobuf::uint32, WireFormatLite::TYPE_UINT32>(Input, *static_cast<uint32*>(Value));
+			case EFieldKind::UInt64:
+				return ReadScalar< ::google::protobuf::uint64, WireFormatLite::TYPE_UINT64>(Input, *static_cast<uint64*>(Value));
+			case EFieldKind::SInt32:
+				return ReadScalar< ::google::protobuf::int32, WireFormatLite::TYPE_SINT32>(Input, *static_cast<int32*>(Value));
+			case EFieldKind::SInt64:
+				return ReadScalar< ::google::protobuf::int64, WireFormatLite::TYPE_SINT64>(Input, *static_cast<int64*>(Value));
+			case EFieldKind::Fixed32:
+				return ReadScalar< ::google::protobuf::uint32, WireFormatLite::TYPE_FIXED32>(Input, *static_cast<uint32*>(Value));
+			case EFieldKind::Fixed64:
+				return ReadScalar< ::google::protobuf::uint64, WireFormatLite::TYPE_FIXED64>(Input, *static_cast<uint64*>(Value));
+			case EFieldKind::SFixed32:
+				return ReadScalar< ::google::protobuf::int32, WireFormatLite::TYPE_SFIXED32>(Input, *static_cast<int32*>(Value));
+			case EFieldKind::SFixed64:
+				return ReadScalar< ::google::protobuf::int64, WireFormatLite::TYPE_SFIXED64>(Input, *static_cast<int64*>(Value));
+			case EFieldKind::Float:
+				return ReadScalar<float, WireFormatLite::TYPE_FLOAT>(Input, *static_cast<float*>(Value));
+			case EFieldKind::Double:
+				return ReadScalar<double, WireFormatLite::TYPE_DOUBLE>(Input, *static_cast<double*>(Value));
+			case EFieldKind::Bool:
+				return ReadScalar<bool, WireFormatLite::TYPE_BOOL>(Input, *static_cast<bool*>(Value));
+			case EFieldKind::Enum:
+				return ReadScalar<int, WireFormatLite::TYPE_ENUM>(Input, *static_cast<uint8*>(Value));
+			case EFieldKind::String:
+				return ReadString(Input, *static_cast<FString*>(Value));
+			case EFieldKind::LazyString:
+				return ReadString(Input, *static_cast<FProtoLazyString*>(Value));
+			case EFieldKind::Name:
+				return ReadString(Input, *static_cast<FName*>(Value));
+			case EFieldKind::Bytes:
+				return ReadString(Input, *static_cast<TArray<uint8>*>(Value));
+			case EFieldKind::Message:
+			{
+				int Length;
+				if (!Input->ReadVarintSizeAsInt(&Length))
+				{
+					return false;
+				}
+				const std::pair<CodedInputStream::Limit, int> Limit = Input->IncrementRecursionDepthAndPushLimit(Length);
+				if (Limit.second < 0 || !MergeFromWire(Input, Value, Field.Nested()))
+				{
+					return false;
+				}
+				return Input->DecrementRecursionDepthAndPopLimit(Limit.first);
+			}
+			default:
+				return false;
+			}
+		}
+
+		FORCEINLINE bool IsDefaultValue(EFieldKind Kind, const void* Value)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Int64:
+			case EFieldKind::UInt64:
+			case EFieldKind::SInt64:
+			case EFieldKind::Fixed64:
+			case EFieldKind::SFixed64:
+				return *static_cast<const uint64*>(Value) == 0;
+			case EFieldKind::Float:
+				return *static_cast<const float*>(Value) == 0;
+			case EFieldKind::Double:
+				return *static_cast<const double*>(Value) == 0;
+			case EFieldKind::Bool:
+			case EFieldKind::Enum:
+				return *static_cast<const uint8*>(Value) == 0;
+			case EFieldKind::String:
+				return static_cast<const FString*>(Value)->IsEmpty();
+			case EFieldKind::LazyString:
+				return static_cast<const FProtoLazyString*>(Value)->IsEmpty();
+			case EFieldKind::Name:
+				return static_cast<const FName*>(Value)->IsNone();
+			case EFieldKind::Bytes:
+				return static_cast<const TArray<uint8>*>(Value)->Num() == 0;
+			case EFieldKind::Message:
+				return false;
+			default:
+				return *static_cast<const uint32*>(Value) == 0;
+			}
+		}
+
+		FORCEINLINE int32& CachedSize(const void* Object, const FMessageTable& Table)
+		{
+			return *reinterpret_cast<int32*>(const_cast<uint8*>(static_cast<const uint8*>(Object)) + Table.CachedSizeOffset);
+		}
+
+		// Encoded size of one value without its tag. bCached reuses the size a
+		// nested struct stored during the preceding size pass.
+		inline size_t ValueSize(EFieldKind Kind, const FFieldEntry& Field, const void* Value, bool bCached)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Int32:
+				return WireFormatLite::Int32Size(*static_cast<const int32*>(Value));
+			case EFieldKind::Int64:
+				return WireFormatLite::Int64Size(*static_cast<const int64*>(Value));
+			case EFieldKind::UInt32:
+				return WireFormatLite::UInt32Size(*static_cast<const uint32*>(Value));
+			case EFieldKind::UInt64:
+				return WireFormatLite::UInt64Size(*static_cast<const uint64*>(Value));
+			case EFieldKind::SInt32:
+				return WireFormatLite::SInt32Size(*static_cast<const int32*>(Value));
+			case EFieldKind::SInt64:
+				return WireFormatLite::SInt64Size(*static_cast<const int64*>(Value));
+			case EFieldKind::Fixed32:
+			case EFieldKind::SFixed32:
+			case EFieldKind::Float:
+				return 4;
+			case EFieldKind::Fixed64:
+			case EFieldKind::SFixed64:
+			case EFieldKind::Double:
+				return 8;
+			case EFieldKind::Bool:
+				return 1;
+			case EFieldKind::Enum:
+				return WireFormatLite::EnumSize(*static_cast<const uint8*>(Value));
+			case EFieldKind::String:
+				return StringWireSize(*static_cast<const FString*>(Value));
+			case EFieldKind::LazyString:
+				return WireFormatLite::StringSize(static_cast<const FProtoLazyString*>(Value)->GetUtf8());
+			case EFieldKind::Name:
+				return StringWireSize(*static_cast<const FName*>(Value));
+			case EFieldKind::Bytes:
+				return StringWireSize(*static_cast<const TArray<uint8>*>(Value));
+			case EFieldKind::Message:
+			{
+				const FMessageTable& Nested = Field.Nested();
+				const int32 Size = bCached ? CachedSize(Value, Nested) : static_cast<int32>(ComputeWireSize(Value, Nested));
+				return CodedOutputStream::VarintSize32(static_cast<uint32>(Size)) + Size;
+			}
+			default:
+				return 0;
+			}
+		}
+
+		inline uint8* WriteValue(EFieldKind Kind, const FFieldEntry& Field, const void* Value, uint8* Target)
+		{
+			switch (Kind)
+			{
+			case EFieldKind::Int32:
+				return WireFormatLite::WriteInt32NoTagToArray(*static_cast<const int32*>(Value), Target);
+			case EFieldKind::Int64:
+				return WireFormatLite::WriteInt64NoTagToArray(*static_cast<const int64*>(Value), Target);
+			case EFieldKind::UInt32:
+				return WireFormatLite::WriteUInt32NoTagToArray(*static_cast<const uint32*>(Value), Target);
+			case EFieldKind::UInt64:
+				return WireFormatLite::WriteUInt64NoTagToArray(*static_cast<const uint64*>(Value), Target);
+			case EFieldKind::SInt32:
+				return WireFormatLite::WriteSInt32NoTagToArray(*static_cast<const int32*>(Value), Target);
+			case EFieldKind::SInt64:
+				return WireFormatLite::WriteSInt64NoTagToArray(*static_cast<const int64*>(Value), Target);
+			case EFieldKind::Fixed32:
+				return WireFormatLite::WriteFixed32NoTagToArray(*static_cast<const uint32*>(Value), Target);
+			case EFieldKind::Fixed64:
+				return WireFormatLite::WriteFixed64NoTagToArray(*static_cast<const uint64*>(Value), Target);
+			case EFieldKind::SFixed32:
+				return WireFormatLite::WriteSFixed32NoTagToArray(*static_cast<const int32*>(Value), Target);
+			case EFieldKind::SFixed64:
+				return WireFormatLite::WriteSFixed64NoTagToArray(*static_cast<const int64*>(Value), Target);
+			case EFieldKind::Float:
+				return WireFormatLite::WriteFloatNoTagToArray(*static_cast<const float*>(Value), Target);
+			case EFieldKind::Double:
+				return WireFormatLite::WriteDoubleNoTagToArray(*static_cast<const double*>(Value), Target);
+			case EFieldKind::Bool:
+				return WireFormatLite::WriteBoolNoTagToArray(*static_cast<const bool*>(Value), Target);
+			case EFieldKind::Enum:
+				return WireFormatLite::WriteEnumNoTagToArray(*static_cast<const uint8*>(Value), Target);
+			case EFieldKind::String:
+				return WriteStringNoTagToArray(*static_cast<const FString*>(Value), Target);
+			case EFieldKind::LazyString:
+				return CodedOutputStream::WriteStringWithSizeToArray(static_cast<const FProtoLazyString*>(Value)->GetUtf8(), Target);
+			case EFieldKind::Name:
+				return WriteStringNoTagToArray(*static_cast<const FName*>(Value), Target);
+			case EFieldKind::Bytes:
+				return WriteStringNoTagToArray(*static_cast<const TArray<uint8>*>(Value), Target);
+			case EFieldKind::Message:
+			{
+				const FMessageTable& Nested = Field.Nested();
+				Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(CachedSize(Value, Nested)), Target);
+				return SerializeWire(Value, Nested, Target);
+			}
+			default:
+				return Target;
+			}
+		}
+
+		FORCEINLINE size_t TagSize(int32 Number)
+		{
+			return CodedOutputStream::VarintSize32(static_cast<uint32>(Number) << 3);
+		}
+
+		FORCEINLINE bool IsFieldDirty(const void* Object, const FMessageTable& Table, const FFieldEntry& Field)
+		{
+			if (Table.DirtyBitsOffset < 0 || Field.DirtyBit < 0)
+			{
+				return true;
+			}
+			const uint32* Bits = reinterpret_cast<const uint32*>(static_cast<const uint8*>(Object) + Table.DirtyBitsOffset);
+			return (Bits[Field.DirtyBit / 32] & (1u << (Field.DirtyBit % 32))) != 0;
+		}
+
+		// Appends one element to the TArray at Member and returns it.
+		FORCEINLINE void* AddElement(void* Member, const FFieldEntry& Field, int32 ElementSize)
+		{
+			FScriptArray& Array = *static_cast<FScriptArray*>(Member);
+			const int32 Index = Array.Add(1, ElementSize);
+			void* Element = static_cast<uint8*>(Array.GetData()) + Index * ElementSize;
+			if (Field.Kind == EFieldKind::Message)
+			{
+				Field.Nested().Construct(Element);
+			}
+			else if (Field.Kind == EFieldKind::LazyString)
+			{
+				new (Element) FProtoLazyString();
+			}
+			else
+			{
+				// All-zero is a valid empty FString, TArray and NAME_None as
+				// well as a zero scalar.
+				FMemory::Memzero(Element, ElementSize);
+			}
+			return Element;
+		}
+
+		inline bool ReadPacked(CodedInputStream* Input, const FFieldEntry& Field, void* Member)
+		{
+			int Length;
+			if (!Input->ReadVarintSizeAsInt(&Length))
+			{
+				return false;
+			}
+
+			const int32 ElementSize = KindStorageSize(Field.Kind, Field);
+			const int32 FixedSize = KindFixedWireSize(Field.Kind);
+			const void* Data;
+			int Size;
+			if (FixedSize > 0 && Length % FixedSize == 0 && Input->GetDirectBufferPointer(&Data, &Size) && Size >= Length)
+			{
+				// Little endian on the wire and on every UE target.
+				FScriptArray& Array = *static_cast<FScriptArray*>(Member);
+				const int32 Index = Array.Add(Length / FixedSize, ElementSize);
+				FMemory::Memcpy(static_cast<uint8*>(Array.GetData()) + Index * ElementSize, Data, Length);
+				return Input->Skip(Length);
+			}
+
+			const CodedInputStream::Limit Limit = Input->PushLimit(Length);
+			while (Input->BytesUntilLimit() > 0)
+			{
+				if (!ReadValue(Input, Field.Kind, Field, AddElement(Member, Field, ElementSize)))
+				{
+					return false;
+				}
+			}
+			Input->PopLimit(Limit);
+			return true;
+		}
+
+		// Returns 1 when the value was read, 0 on a parse error and -1 when the
+		// wire type does not match, in which case the caller skips it.
+		inline int32 ReadField(CodedInputStream* Input, void* Object, const FFieldEntry& Field, WireFormatLite::WireType WireType)
+		{
+			void* Member = static_cast<uint8*>(Object) + Field.Offset;
+			const WireFormatLite::WireType Expected = KindWireType(Field.Kind);
+
+			if (Field.Kind == EFieldKind::Custom)
+			{
+				return WireType == Expected ? Field.Custom->Parse(Input, Member) : -1;
+			}
+			if ((Field.Flags & EFieldFlags::Repeated) == 0)
+			{
+				return WireType == Expected ? ReadValue(Input, Field.Kind, Field, Member) : -1;
+			}
+			if (WireType == Expected)
+			{
+				return ReadValue(Input, Field.Kind, Field, AddElement(Member, Field, KindStorageSize(Field.Kind, Field)));
+			}
+			// Parsers must accept both encodings of a packable field.
+			if (WireType == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+			{
+				return ReadPacked(Input, Field, Member);
+			}
+			return -1;
+		}
+
+		FORCEINLINE const FFieldEntry* FindField(const FMessageTable& Table, int32 Number, int32& Cursor)
+		{
+			// Fields normally arrive in number order, try the next entry first.
+			if (Cursor < Table.NumFields && Table.Fields[Cursor].Number == Number)
+			{
+				return &Table.Fields[Cursor++];
+			}
+			int32 Low = 0;
+			int32 High = Table.NumFields;
+			while (Low < High)
+			{
+				const int32 Mid = (Low + High) / 2;
+				if (Table.Fields[Mid].Number < Number)
+				{
+					Low = Mid + 1;
+				}
+				else
+				{
+					High = Mid;
+				}
+			}
+			if (Low < Table.NumFields && Table.Fields[Low].Number == Number)
+			{
+				Cursor = Low + 1;
+				return &Table.Fields[Low];
+			}
+			return nullptr;
+		}
+
+		// Payload length of a packed field.
+		inline size_t PackedDataSize(const FFieldEntry& Field, const FScriptArray& Array)
+		{
+			const int32 FixedSize = KindFixedWireSize(Field.Kind);
+			if (FixedSize > 0 || Field.Kind == EFieldKind::Bool)
+			{
+				return static_cast<size_t>(FMath::Max(FixedSize, 1)) * Array.Num();
+			}
+			const int32 ElementSize = KindStorageSize(Field.Kind, Field);
+			const uint8* Data = static_cast<const uint8*>(Array.GetData());
+			size_t DataSize = 0;
+			for (int32 Index = 0; Index < Array.Num(); ++Index)
+			{
+				DataSize += ValueSize(Field.Kind, Field, Data + Index * ElementSize, false);
+			}
+			return DataSize;
+		}
+	}
+
+	inline bool MergeFromWire(CodedInputStream* Input, void* Object, const FMessageTable& Table)
+	{
+		int32 Cursor = 0;
+		for (;;)
+		{
+			const uint32 Tag = Input->ReadTag();
+			if (Tag == 0)
+			{
+				return true;
+			}
+			const FFieldEntry* Field = Private::FindField(Table, WireFormatLite::GetTagFieldNumber(Tag), Cursor);
+			if (Field != nullptr)
+			{
+				const int32 Result = Private::ReadField(Input, Object, *Field, WireFormatLite::GetTagWireType(Tag));
+				if (Result == 0)
+				{
+					return false;
+				}
+				if (Result > 0)
+				{
+					continue;
+				}
+			}
+			if (!WireFormatLite::SkipField(Input, Tag))
+			{
+				return false;
+			}
+		}
+	}
+
+	inline size_t ComputeWireSize(const void* Object, const FMessageTable& Table)
+	{
+		size_t Total = 0;
+		for (int32 FieldIndex = 0; FieldIndex < Table.NumFields; ++FieldIndex)
+		{
+			const FFieldEntry& Field = Table.Fields[FieldIndex];
+			if (!Private::IsFieldDirty(Object, Table, Field))
+			{
+				continue;
+			}
+			const void* Member = static_cast<const uint8*>(Object) + Field.Offset;
+			const size_t TagSize = Private::TagSize(Field.Number);
+
+			if (Field.Kind == EFieldKind::Custom)
+			{
+				Total += Field.Custom->ByteSize(Member, Field.Number);
+			}
+			else if ((Field.Flags & EFieldFlags::Repeated) == 0)
+			{
+				if ((Field.Flags & EFieldFlags::SkipDefault) == 0 || !Private::IsDefaultValue(Field.Kind, Member))
+				{
+					Total += TagSize + Private::ValueSize(Field.Kind, Field, Member, false);
+				}
+			}
+			else
+			{
+				const FScriptArray& Array = *static_cast<const FScriptArray*>(Member);
+				if ((Field.Flags & EFieldFlags::Packed) != 0)
+				{
+					const size_t DataSize = Private::PackedDataSize(Field, Array);
+					if (DataSize > 0)
+					{
+						Total += TagSize + CodedOutputStream::VarintSize32(static_cast<uint32>(DataSize)) + DataSize;
+					}
+				}
+				else
+				{
+					const int32 ElementSize = Private::KindStorageSize(Field.Kind, Field);
+					const uint8* Data = static_cast<const uint8*>(Array.GetData());
+					Total += TagSize * Array.Num();
+					for (int32 Index = 0; Index < Array.Num(); ++Index)
+					{
+						Total += Private::ValueSize(Field.Kind, Field, Data + Index * ElementSize, false);
+					}
+				}
+			}
+		}
+		if (Table.CachedSizeOffset >= 0)
+		{
+			Private::CachedSize(Object, Table) = static_cast<int32>(Total);
+		}
+		return Total;
+	}
+
+	// Requires a ComputeWireSize() pass over Object first.
+	inline uint8* SerializeWire(const void* Object, const FMessageTable& Table, uint8* Target)
+	{
+		for (int32 FieldIndex = 0; FieldIndex < Table.NumFields; ++FieldIndex)
+		{
+			const FFieldEntry& Field = Table.Fields[FieldIndex];
+			if (!Private::IsFieldDirty(Object, Table, Field))
+			{
+				continue;
+			}
+			const void* Member = static_cast<const uint8*>(Object) + Field.Offset;
+			const WireFormatLite::WireType WireType = Private::KindWireType(Field.Kind);
+
+			if (Field.Kind == EFieldKind::Custom)
+			{
+				Target = Field.Custom->Write(Member, Field.Number, Target);
+			}
+			else if ((Field.Flags & EFieldFlags::Repeated) == 0)
+			{
+				if ((Field.Flags & EFieldFlags::SkipDefault) == 0 || !Private::IsDefaultValue(Field.Kind, Member))
+				{
+					Target = WireFormatLite::WriteTagToArray(Field.Number, WireType, Target);
+					Target = Private::WriteValue(Field.Kind, Field, Member, Target);
+				}
+			}
+			else
+			{
+				const FScriptArray& Array = *static_cast<const FScriptArray*>(Member);
+				const int32 ElementSize = Private::KindStorageSize(Field.Kind, Field);
+				const uint8* Data = static_cast<const uint8*>(Array.GetData());
+				if ((Field.Flags & EFieldFlags::Packed) != 0)
+				{
+					if (Array.Num() == 0)
+					{
+						continue;
+					}
+					const size_t DataSize = Private::PackedDataSize(Field, Array);
+					Target = WireFormatLite::WriteTagToArray(Field.Number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+					Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(DataSize), Target);
+					for (int32 Index = 0; Index < Array.Num(); ++Index)
+					{
+						Target = Private::WriteValue(Field.Kind, Field, Data + Index * ElementSize, Target);
+					}
+				}
+				else
+				{
+					for (int32 Index = 0; Index < Array.Num(); ++Index)
+					{
+						Target = WireFormatLite::WriteTagToArray(Field.Number, WireType, Target);
+						Target = Private::WriteValue(Field.Kind, Field, Data + Index * ElementSize, Target);
+					}
+				}
+			}
+		}
+		return Target;
+	}
+
+	// FCustomFieldCodec for a TMap member. Map entries are messages with the
+	// key as field 1 and the value as field 2; both are always written.
+	template <typename MapType, EFieldKind KeyKind, EFieldKind ValueKind, const FMessageTable& (*ValueTable)() = nullptr>
+	struct TMapFieldCodec
+	{
+		typedef typename MapType::ElementType FEntry;
+
+		static const FFieldEntry& KeyField()
+		{
+			static const FFieldEntry Field = { 1, 0, KeyKind, EFieldFlags::None, -1, nullptr, nullptr };
+			return Field;
+		}
+
+		static const FFieldEntry& ValueField()
+		{
+			static const FFieldEntry Field = { 2, 0, ValueKind, EFieldFlags::None, -1, ValueTable, nullptr };
+			return Field;
+		}
+
+		static size_t EntrySize(const FEntry& Entry, bool bCached)
+		{
+			return 2 + Private::ValueSize(KeyKind, KeyField(), &Entry.Key, bCached)
+				+ Private::ValueSize(ValueKind, ValueField(), &Entry.Value, bCached);
+		}
+
+		static bool Parse(CodedInputStream* Input, void* Member)
+		{
+			int Length;
+			if (!Input->ReadVarintSizeAsInt(&Length))
+			{
+				return false;
+			}
+			const std::pair<CodedInputStream::Limit, int> Limit = Input->IncrementRecursionDepthAndPushLimit(Length);
+			if (Limit.second < 0)
+			{
+				return false;
+			}
+
+			// Missing keys/values stay default, a repeated key replaces the
+			// earlier entry, as with protobuf's Map.
+			FEntry Entry;
+			const uint32 KeyTag = WireFormatLite::MakeTag(1, Private::KindWireType(KeyKind));
+			const uint32 ValueTag = WireFormatLite::MakeTag(2, Private::KindWireType(ValueKind));
+			for (uint32 Tag = Input->ReadTag(); Tag != 0; Tag = Input->ReadTag())
+			{
+				const bool bRead = Tag == KeyTag ? Private::ReadValue(Input, KeyKind, KeyField(), &Entry.Key)
+					: Tag == ValueTag ? Private::ReadValue(Input, ValueKind, ValueField(), &Entry.Value)
+					: WireFormatLite::SkipField(Input, Tag);
+				if (!bRead)
+				{
+					return false;
+				}
+			}
+			if (!Input->DecrementRecursionDepthAndPopLimit(Limit.first))
+			{
+				return false;
+			}
+			static_cast<MapType*>(Member)->Add(MoveTemp(Entry.Key), MoveTemp(Entry.Value));
+			return true;
+		}
+
+		static size_t ByteSize(const void* Member, int32 Number)
+		{
+			const MapType& Map = *static_cast<const MapType*>(Member);
+			size_t Total = Private::TagSize(Number) * Map.Num();
+			for (const FEntry& Entry : Map)
+			{
+				const size_t Size = EntrySize(Entry, false);
+				Total += CodedOutputStream::VarintSize32(static_cast<uint32>(Size)) + Size;
+			}
+			return Total;
+		}
+
+		static uint8* Write(const void* Member, int32 Number, uint8* Target)
+		{
+			const MapType& Map = *static_cast<const MapType*>(Member);
+			for (const FEntry& Entry : Map)
+			{
+				Target = WireFormatLite::WriteTagToArray(Number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+				Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(EntrySize(Entry, true)), Target);
+				Target = WireFormatLite::WriteTagToArray(1, Private::KindWireType(KeyKind), Target);
+				Target = Private::WriteValue(KeyKind, KeyField(), &Entry.Key, Target);
+				Target = WireFormatLite::WriteTagToArray(2, Private::KindWireType(ValueKind), Target);
+				Target = Private::WriteValue(ValueKind, ValueField(), &Entry.Value, Target);
+			}
+			return Target;
+		}
+
+		static const FCustomFieldCodec Codec;
+	};
+
+	template <typename MapType, EFieldKind KeyKind, EFieldKind ValueKind, const FMessageTable& (*ValueTable)()>
+	const FCustomFieldCodec TMapFieldCodec<MapType, KeyKind, ValueKind, ValueTable>::Codec =
+	{
+		&TMapFieldCodec::Parse,
+		&TMapFieldCodec::ByteSize,
+		&TMapFieldCodec::Write,
+	};
+
+	// FromPB/UnPack of a table-driven type: the protobuf message is turned back
+	// into bytes and interpreted, so no per-field conversion code is needed.
+	// Returns false if the bytes do not decode, Out is then partially merged.
+	template <typename StructType>
+	bool MergeFromMessage(const ::google::protobuf::MessageLite& Message, StructType& Out)
+	{
+		static thread_local std::string Bytes;
+		Bytes.clear();
+		if (!Message.AppendToString(&Bytes))
+		{
+			return false;
+		}
+		CodedInputStream Input(reinterpret_cast<const uint8*>(Bytes.data()), static_cast<int>(Bytes.size()));
+		return MergeFromWire(&Input, &Out, StructType::WireTable());
+	}
+
+	// ToPB of a table-driven type. Returns false if protobuf rejects the
+	// serialized members (e.g. invalid UTF-8 in a proto3 string).
+	template <typename StructType>
+	bool ToMessage(const StructType& In, ::google::protobuf::MessageLite& Message)
+	{
+		static thread_local TArray<uint8> Bytes;
+		Bytes.SetNumUninitialized(static_cast<int32>(ComputeWireSize(&In, StructType::WireTable())), false);
+		SerializeWire(&In, StructType::WireTable(), Bytes.GetData());
+		return Message.ParseFromArray(Bytes.GetData(), Bytes.Num());
+	}
+}
@@ -0,0 +1,332 @@
+// Wire-format helpers used by the ComputeWireSize()/SerializeWire() methods
+// the generator emits with the direct_serialization option, and by the
+// MergeFromWire() methods of the direct_parsing option.
+//
+// Scalars go through WireFormatLite directly; this header only adds the
+// pieces that deal with UE types: FString and FName fields are transcoded straight
+// between UTF-8 on the wire and TCHAR, nested structs reuse the size cached by
+// the preceding ComputeWireSize() pass, and repeated scalars are read into
+// TArray without going through RepeatedField.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProtoUEString.h"
+#include "ProtoUELazyString.h"
+#include "ProtoUEName.h"
+#include "ProtoUEBytes.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+namespace ProtoUE
+{
+	typedef ::google::protobuf::internal::WireFormatLite WireFormatLite;
+	typedef ::google::protobuf::io::CodedOutputStream CodedOutputStream;
+	typedef ::google::protobuf::io::CodedInputStream CodedInputStream;
+
+	// Length prefix plus UTF-8 payload of Value, without the tag.
+	inline size_t StringWireSize(const FString& Value)
+	{
+		const int32 Len = Utf8Length(Value);
+		return CodedOutputStream::VarintSize32(static_cast<uint32>(Len)) + Len;
+	}
+
+	inline uint8* WriteStringNoTagToArray(const FString& Value, uint8* Target)
+	{
+		Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(Utf8Length(Value)), Target);
+		return WriteUtf8(Value, Target);
+	}
+
+	inline uint8* WriteStringToArray(int FieldNumber, const FString& Value, uint8* Target)
+	{
+		Target = WireFormatLite::WriteTagToArray(FieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+		return WriteStringNoTagToArray(Value, Target);
+	}
+
+	// FName fields go through the per-thread name buffer, so the size and the
+	// write pass each look the name up once.
+	inline size_t StringWireSize(const FName& Value)
+	{
+		if (Value.IsNone())
+		{
+			return 1;
+		}
+		FString& Text = Private::NameBuffer();
+		Value.ToString(Text);
+		return StringWireSize(Text);
+	}
+
+	inline uint8* WriteStringNoTagToArray(const FName& Value, uint8* Target)
+	{
+		if (Value.IsNone())
+		{
+			return CodedOutputStream::WriteVarint32ToArray(0, Target);
+		}
+		FString& Text = Private::NameBuffer();
+		Value.ToString(Text);
+		return WriteStringNoTagToArray(Text, Target);
+	}
+
+	inline uint8* WriteStringToArray(int FieldNumber, const FName& Value, uint8* Target)
+	{
+		Target = WireFormatLite::WriteTagToArray(FieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+		return WriteStringNoTagToArray(Value, Target);
+	}
+
+	// bytes fields are copied as is.
+	template <typename AllocatorType>
+	size_t StringWireSize(const TArray<uint8, AllocatorType>& Value)
+	{
+		return CodedOutputStream::VarintSize32(static_cast<uint32>(Value.Num())) + Value.Num();
+	}
+
+	template <typename AllocatorType>
+	uint8* WriteStringNoTagToArray(const TArray<uint8, AllocatorType>& Value, uint8* Target)
+	{
+		Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(Value.Num()), Target);
+		return CodedOutputStream::WriteRawToArray(Value.GetData(), Value.Num(), Target);
+	}
+
+	template <typename AllocatorType>
+	uint8* WriteStringToArray(int FieldNumber, const TArray<uint8, AllocatorType>& Value, uint8* Target)
+	{
+		Target = WireFormatLite::WriteTagToArray(FieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+		return WriteStringNoTagToArray(Value, Target);
+	}
+
+	// Length prefix plus payload of a generated struct, without the tag.
+	// Refreshes Value.CachedWireSize for the following SerializeWire().
+	template <typename MessageType>
+	size_t MessageWireSize(const MessageType& Value)
+	{
+		const int32 Size = Value.ComputeWireSize();
+		return CodedOutputStream::VarintSize32(static_cast<uint32>(Size)) + Size;
+	}
+
+	// Same as MessageWireSize() but trusts the size cached by the last pass.
+	template <typename MessageType>
+	size_t CachedMessageWireSize(const MessageType& Value)
+	{
+		return CodedOutputStream::VarintSize32(static_cast<uint32>(Value.CachedWireSize)) + Value.CachedWireSize;
+	}
+
+	template <typename MessageType>
+	uint8* WriteMessageNoTagToArray(const MessageType& Value, uint8* Target)
+	{
+		Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(Value.CachedWireSize), Target);
+		return Value.SerializeWire(Target);
+	}
+
+	template <typename MessageType>
+	uint8* WriteMessageToArray(int FieldNumber, const MessageType& Value, uint8* Target)
+	{
+		Target = WireFormatLite::WriteTagToArray(FieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);
+		return WriteMessageNoTagToArray(Value, Target);
+	}
+
+	// Reads one value of wire type DeclaredType and stores it in Out, which may
+	// be any UE type the protobuf C++ type converts to (including UENUMs).
+	template <typename WireCppType, WireFormatLite::FieldType DeclaredType, typename T>
+	FORCEINLINE bool ReadScalar(CodedInputStream* Input, T& Out)
+	{
+		WireCppType Value;
+		if (!WireFormatLite::ReadPrimitive<WireCppType, DeclaredType>(Input, &Value))
+		{
+			return false;
+		}
+		Out = static_cast<T>(Value);
+		return true;
+	}
+
+	template <typename WireCppType, WireFormatLite::FieldType DeclaredType, typename T, typename AllocatorType>
+	bool ReadPackedScalars(CodedInputStream* Input, TArray<T, AllocatorType>& Out)
+	{
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length))
+		{
+			return false;
+		}
+		const CodedInputStream::Limit Limit = Input->PushLimit(Length);
+		while (Input->BytesUntilLimit() > 0)
+		{
+			WireCppType Value;
+			if (!WireFormatLite::ReadPrimitive<WireCppType, DeclaredType>(Input, &Value))
+			{
+				return false;
+			}
+			Out.Add(static_cast<T>(Value));
+		}
+		Input->PopLimit(Limit);
+		return true;
+	}
+
+	// Packed fixed width values are little endian on the wire, like every UE
+	// target, so a run that is already in the input buffer is copied in one go.
+	template <typename WireCppType, WireFormatLite::FieldType DeclaredType, typename T, typename AllocatorType>
+	bool ReadPackedFixed(CodedInputStream* Input, TArray<T, AllocatorType>& Out)
+	{
+		static_assert(sizeof(T) == sizeof(WireCppType), "Element type must match the wire width");
+
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length) || Length % sizeof(T) != 0)
+		{
+			return false;
+		}
+
+		const void* Data;
+		int Size;
+		if (Input->GetDirectBufferPointer(&Data, &Size) && Size >= Length)
+		{
+			const int32 Count = Length / sizeof(T);
+			const int32 Offset = Out.AddUninitialized(Count);
+			FMemory::Memcpy(Out.GetData() + Offset, Data, Length);
+			return Input->Skip(Length);
+		}
+
+		const CodedInputStream::Limit Limit = Input->PushLimit(Length);
+		while (Input->BytesUntilLimit() > 0)
+		{
+			WireCppType Value;
+			if (!WireFormatLite::ReadPrimitive<WireCppType, DeclaredType>(Input, &Value))
+			{
+				return false;
+			}
+			Out.Add(static_cast<T>(Value));
+		}
+		Input->PopLimit(Limit);
+		return true;
+	}
+
+	// Decodes a length-delimited UTF-8 value straight from the input buffer
+	// when it is contiguous there.
+	inline bool ReadString(CodedInputStream* Input, FString& Out)
+	{
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length))
+		{
+			return false;
+		}
+
+		const void* Data;
+		int Size;
+		if (Input->GetDirectBufferPointer(&Data, &Size) && Size >= Length)
+		{
+			Utf8ToFString(static_cast<const char*>(Data), Length, Out);
+			return Input->Skip(Length);
+		}
+
+		std::string Buffer;
+		if (!Input->ReadString(&Buffer, Length))
+		{
+			return false;
+		}
+		Utf8ToFString(Buffer, Out);
+		return true;
+	}
+
+	inline bool ReadString(CodedInputStream* Input, FProtoLazyString& Out)
+	{
+		std::string Buffer;
+		if (!WireFormatLite::ReadString(Input, &Buffer))
+		{
+			return false;
+		}
+		Out.SetUtf8(MoveTemp(Buffer));
+		return true;
+	}
+
+	inline bool ReadString(CodedInputStream* Input, FName& Out)
+	{
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length))
+		{
+			return false;
+		}
+
+		const void* Data;
+		int Size;
+		// A value too long to be a name fails the parse.
+		if (Input->GetDirectBufferPointer(&Data, &Size) && Size >= Length)
+		{
+			return TryUtf8ToFName(static_cast<const char*>(Data), Length, Out) && Input->Skip(Length);
+		}
+
+		std::string Buffer;
+		return Input->ReadString(&Buffer, Length)
+			&& TryUtf8ToFName(Buffer.data(), static_cast<int32>(Buffer.size()), Out);
+	}
+
+	template <typename AllocatorType>
+	bool ReadString(CodedInputStream* Input, TArray<uint8, AllocatorType>& Out)
+	{
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length))
+		{
+			return false;
+		}
+
+		// Only size Out once the bytes are known to be there, a bogus length
+		// must not turn into an allocation.
+		const void* Data;
+		int Size;
+		if (Input->GetDirectBufferPointer(&Data, &Size) && Size >= Length)
+		{
+			StringToBytes(static_cast<const char*>(Data), Length, Out);
+			return Input->Skip(Length);
+		}
+
+		std::string Buffer;
+		if (!Input->ReadString(&Buffer, Length))
+		{
+			return false;
+		}
+		StringToBytes(Buffer, Out);
+		return true;
+	}
+
+	// Points Out into the input buffer itself, so it is only valid while that
+	// buffer is. Requires the whole value to be contiguous there, which is
+	// always the case for input read from an array.
+	inline bool ReadString(CodedInputStream* Input, TArrayView<const uint8>& Out)
+	{
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length))
+		{
+			return false;
+		}
+
+		const void* Data;
+		int Size;
+		if (Length == 0)
+		{
+			Out = TArrayView<const uint8>();
+			return true;
+		}
+		if (!Input->GetDirectBufferPointer(&Data, &Size) || Size < Length)
+		{
+			return false;
+		}
+		Out = TArrayView<const uint8>(static_cast<const uint8*>(Data), Length);
+		return Input->Skip(Length);
+	}
+
+	// Merges a length-delimited generated struct into Out, with the same
+	// recursion limit as protobuf's own parser.
+	template <typename MessageType>
+	bool ReadMessage(CodedInputStream* Input, MessageType& Out)
+	{
+		int Length;
+		if (!Input->ReadVarintSizeAsInt(&Length))
+		{
+			return false;
+		}
+		const std::pair<CodedInputStream::Limit, int> Limit = Input->IncrementRecursionDepthAndPushLimit(Length);
+		if (Limit.second < 0 || !Out.MergeFromWire(Input))
+		{
+			return false;
+		}
+		return Input->DecrementRecursionDepthAndPopLimit(Limit.first);
+	}
+}
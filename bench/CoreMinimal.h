@@ -0,0 +1,44 @@
+// The few engine definitions Runtime/ProtoUECompression.h uses, backed by the
+// standard library, so the codec can be benchmarked without the engine.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#define FORCEINLINE inline
+
+typedef std::uint8_t uint8;
+typedef std::uint32_t uint32;
+typedef std::uint64_t uint64;
+typedef std::int32_t int32;
+typedef std::int64_t int64;
+
+#define MAX_int32 0x7fffffff
+
+struct FMemory
+{
+	static void* Memcpy(void* Dest, const void* Src, size_t Count) { return std::memcpy(Dest, Src, Count); }
+	static void* Memset(void* Dest, uint8 Char, size_t Count) { return std::memset(Dest, Char, Count); }
+};
+
+struct FMath
+{
+	template <typename T>
+	static T Min(T A, T B) { return std::min(A, B); }
+};
+
+template <typename T>
+class TArray
+{
+public:
+	void SetNumUninitialized(int32 Num, bool = true) { Data.resize(Num); }
+	T* GetData() { return Data.data(); }
+	const T* GetData() const { return Data.data(); }
+	int32 Num() const { return static_cast<int32>(Data.size()); }
+
+private:
+	std::vector<T> Data;
+};
@@ -0,0 +1,284 @@
+// Round-trip check and throughput benchmark for the payload codec in
+// Runtime/ProtoUECompression.h, on serialized messages of the shapes in
+// bench_messages.proto. Builds without the engine:
+//
+//   mkdir -p _bench
+//   protoc -Ibench --cpp_out=_bench bench/bench_messages.proto
+//   g++ -std=c++17 -O2 -Ibench -I_bench bench/compression_bench.cc _bench/bench_messages.pb.cc -lprotobuf -o _bench/compression_bench
+//   _bench/compression_bench
+//
+// Every payload is compressed, framed, decoded again and compared with the
+// input, and the messages are parsed back from the decoded bytes; the
+// program exits non-zero on the first mismatch. It then reports the
+// compression ratio and the compress/decompress speed per message.
+
+#include "../Runtime/ProtoUECompression.h"
+#include "bench_messages.pb.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	typedef std::vector<uint8> FBytes;
+
+	using namespace Dolphin::Protocol;
+
+	const char* const Names[] = { "Aldric", "Brenna", "Caspian", "Dagny", "Evander", "Freya", "Gideon", "Hilde" };
+	const char* const Guilds[] = { "Iron Wolves", "Dawnguard", "Silver Hand", "" };
+
+	std::string PlayerName(std::mt19937& Random)
+	{
+		return std::string(Names[Random() % 8]) + std::to_string(Random() % 10000);
+	}
+
+	// Mails come from a handful of templates with a few substituted values.
+	MailListResp MakeMailList(int32 Count, std::mt19937& Random)
+	{
+		MailListResp Message;
+		int64 Now = 1760000000;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Mail* Entry = Message.add_mails();
+			const int32 Template = Random() % 4;
+			Entry->set_mail_id(100000 + Index);
+			Entry->set_template_id(Template);
+			Entry->set_sender(Template == 0 ? PlayerName(Random) : "System");
+			Entry->set_title(Template == 0 ? "Guild gift" : Template == 1 ? "Arena season rewards" : "Maintenance compensation");
+			Entry->set_body("Dear commander, thank you for your patience during the maintenance on server "
+				+ std::to_string(Random() % 40) + ". Please collect the attached rewards before they expire.");
+			Entry->set_send_time(Now - Random() % 604800);
+			Entry->set_expire_time(Entry->send_time() + 2592000);
+			Entry->set_read(Random() % 2 == 0);
+			for (uint32 Attachment = Random() % 4; Attachment > 0; --Attachment)
+			{
+				MailAttachment* Item = Entry->add_attachments();
+				Item->set_item_id(1000 + Random() % 50);
+				Item->set_count(1 + Random() % 100);
+			}
+		}
+		return Message;
+	}
+
+	RankingResp MakeRanking(int32 Count, std::mt19937& Random)
+	{
+		RankingResp Message;
+		Message.set_board_id(3);
+		int64 Score = 5000000;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			RankEntry* Entry = Message.add_entries();
+			Entry->set_rank(Index + 1);
+			Entry->set_player_id(10000000 + Random() % 1000000);
+			Entry->set_nick_name(PlayerName(Random));
+			Entry->set_level(30 + Random() % 30);
+			Score -= Random() % 2000;
+			Entry->set_score(Score);
+			Entry->set_guild_name(Guilds[Random() % 4]);
+			Entry->set_avatar_id(Random() % 20);
+		}
+		*Message.mutable_self() = Message.entries(Count / 2);
+		return Message;
+	}
+
+	ConfigSnapshotResp MakeConfigSnapshot(int32 Count, std::mt19937& Random)
+	{
+		static const char* const Tags[] = { "melee", "ranged", "flying", "siege", "elite", "summon" };
+		ConfigSnapshotResp Message;
+		Message.set_version(42);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			UnitConfig* Unit = Message.add_units();
+			Unit->set_id(2000 + Index);
+			Unit->set_name("Unit_" + std::to_string(Index));
+			Unit->set_icon("/Game/UI/Icons/Units/T_Unit_" + std::to_string(Index) + "_Icon");
+			Unit->set_hp(500 + Random() % 5000);
+			Unit->set_attack(50 + Random() % 500);
+			Unit->set_defense(10 + Random() % 200);
+			Unit->set_move_speed(300.0f + Random() % 300);
+			Unit->set_attack_range(100.0f * (1 + Random() % 8));
+			for (uint32 Skill = 1 + Random() % 4; Skill > 0; --Skill)
+			{
+				Unit->add_skill_ids(3000 + Random() % 200);
+			}
+			for (uint32 Tag = Random() % 3; Tag > 0; --Tag)
+			{
+				(*Unit->mutable_tags())[Tags[Random() % 6]] = Random() % 10;
+			}
+		}
+		return Message;
+	}
+
+	FBytes Serialize(const ::google::protobuf::MessageLite& Message)
+	{
+		const std::string Bytes = Message.SerializeAsString();
+		return FBytes(Bytes.begin(), Bytes.end());
+	}
+
+	FBytes MakeRandom(size_t Size, std::mt19937& Random)
+	{
+		FBytes Out(Size);
+		for (uint8& Byte : Out)
+		{
+			Byte = static_cast<uint8>(Random());
+		}
+		// A message never starts with 0x00, which marks a frame.
+		if (!Out.empty())
+		{
+			Out[0] |= 1;
+		}
+		return Out;
+	}
+
+	FBytes MakeRun(size_t Size)
+	{
+		return FBytes(Size, 0x2a);
+	}
+
+	// Compresses Payload through the framing functions and decodes it again
+	// into *Decoded.
+	bool RoundTrip(const FBytes& Payload, FBytes* Decoded)
+	{
+		const uint8* Data = Payload.data();
+		int32 Size = static_cast<int32>(Payload.size());
+		ProtoUE::CompressPayload(Data, Size, 1);
+
+		// The framed bytes live in the per-thread buffer the next call reuses.
+		const FBytes Framed(Data, Data + Size);
+		const uint8* Bytes = Framed.data();
+		int32 BytesSize = static_cast<int32>(Framed.size());
+		if (!ProtoUE::DecompressPayload(Bytes, BytesSize))
+		{
+			return false;
+		}
+		Decoded->assign(Bytes, Bytes + BytesSize);
+		return *Decoded == Payload;
+	}
+
+	// The decoded bytes must also parse back into the same message.
+	template <typename MessageType>
+	bool RoundTripMessage(const MessageType& Message)
+	{
+		const FBytes Payload = Serialize(Message);
+		FBytes Decoded;
+		MessageType Parsed;
+		return RoundTrip(Payload, &Decoded)
+			&& Parsed.ParseFromArray(Decoded.data(), static_cast<int>(Decoded.size()))
+			&& ::google::protobuf::util::MessageDifferencer::Equals(Parsed, Message);
+	}
+
+	// A frame claiming more output than its block can produce, and truncated
+	// frames, must be rejected.
+	bool RejectsCorruptFrames(const FBytes& Payload)
+	{
+		const uint8 Oversized[] = { 0x00, 0xff, 0xff, 0xff, 0xff, 0x07, 0x10 };
+		const uint8* Bytes = Oversized;
+		int32 Size = sizeof(Oversized);
+		if (ProtoUE::DecompressPayload(Bytes, Size))
+		{
+			return false;
+		}
+
+		const uint8* Data = Payload.data();
+		int32 FramedSize = static_cast<int32>(Payload.size());
+		ProtoUE::CompressPayload(Data, FramedSize, 1);
+		const FBytes Framed(Data, Data + FramedSize);
+		for (int32 Cut = 2; Cut < FramedSize; Cut += FramedSize / 16 + 1)
+		{
+			Bytes = Framed.data();
+			Size = Cut;
+			if (ProtoUE::DecompressPayload(Bytes, Size))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	double MegabytesPerSecond(size_t Bytes, std::chrono::steady_clock::duration Elapsed)
+	{
+		const double Seconds = std::chrono::duration<double>(Elapsed).count();
+		return Seconds > 0 ? Bytes / Seconds / (1024.0 * 1024.0) : 0;
+	}
+
+	void Measure(const char* Kind, const FBytes& Payload)
+	{
+		const int32 SrcSize = static_cast<int32>(Payload.size());
+		FBytes Compressed(ProtoUE::LZ4::CompressBound(SrcSize));
+		FBytes Decompressed(Payload.size());
+		const int Iterations = static_cast<int>(64 * 1024 * 1024 / (Payload.size() + 1)) + 1;
+
+		int32 CompressedSize = 0;
+		const auto CompressStart = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			CompressedSize = ProtoUE::LZ4::Compress(Payload.data(), SrcSize, Compressed.data());
+		}
+		const auto CompressTime = std::chrono::steady_clock::now() - CompressStart;
+
+		const auto DecompressStart = std::chrono::steady_clock::now();
+		for (int Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			ProtoUE::LZ4::Decompress(Compressed.data(), CompressedSize, Decompressed.data(), SrcSize);
+		}
+		const auto DecompressTime = std::chrono::steady_clock::now() - DecompressStart;
+
+		const size_t Total = Payload.size() * Iterations;
+		std::printf("%-24s %8d -> %8d (%5.1f%%)  compress %8.1f MB/s  decompress %8.1f MB/s\n",
+			Kind, SrcSize, CompressedSize, SrcSize ? 100.0 * CompressedSize / SrcSize : 0.0,
+			MegabytesPerSecond(Total, CompressTime), MegabytesPerSecond(Total, DecompressTime));
+	}
+}
+
+int main()
+{
+	GOOGLE_PROTOBUF_VERIFY_VERSION;
+	std::mt19937 Random(20241016);
+
+	// Edge sizes around the codec's limits, with incompressible and highly
+	// repetitive input.
+	const size_t Sizes[] = { 0, 1, 12, 13, 100, 65536, 70000, 1 << 20 };
+	for (size_t Size : Sizes)
+	{
+		const FBytes Payloads[] = { MakeRandom(Size, Random), MakeRun(Size) };
+		for (const FBytes& Payload : Payloads)
+		{
+			FBytes Decoded;
+			if (!RoundTrip(Payload, &Decoded))
+			{
+				std::printf("round trip failed for %zu bytes\n", Size);
+				return 1;
+			}
+		}
+	}
+
+	HeartbeatResp Heartbeat;
+	Heartbeat.set_server_time(1760000000123);
+	const MailListResp Mails = MakeMailList(1000, Random);
+	const RankingResp Ranking = MakeRanking(5000, Random);
+	const ConfigSnapshotResp Config = MakeConfigSnapshot(3000, Random);
+	if (!RoundTripMessage(Heartbeat) || !RoundTripMessage(Mails) || !RoundTripMessage(Ranking) || !RoundTripMessage(Config))
+	{
+		std::printf("message round trip failed\n");
+		return 1;
+	}
+	if (!RejectsCorruptFrames(Serialize(Mails)))
+	{
+		std::printf("corrupt frame accepted\n");
+		return 1;
+	}
+	std::printf("round trips ok\n\n");
+
+	Measure("HeartbeatResp", Serialize(Heartbeat));
+	Measure("MailListResp x20", Serialize(MakeMailList(20, Random)));
+	Measure("MailListResp x1000", Serialize(Mails));
+	Measure("RankingResp x100", Serialize(MakeRanking(100, Random)));
+	Measure("RankingResp x5000", Serialize(Ranking));
+	Measure("ConfigSnapshotResp x3000", Serialize(Config));
+	return 0;
+}
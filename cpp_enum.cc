@@ -1,4 +1,5 @@
 #include <map>
+#include <set>
 
 #include "cpp_enum.h"
 #include "cpp_helpers.h"
@@ -107,45 +108,57 @@ namespace google
                         printer->Print("UCLASS()\n"
                             "class PROJECT_X_API UResponseMap : public UObject\n"
                             "{\n GENERATED_BODY() \n public:\n");
-                        printer->Print("TMap<int, TSubclassOf<UResponse>> ResponseMap = \n{\n");
-                        printer->Annotate("classname", descriptor_);
-                        printer->Indent();
-                        for (int i = 0; i < descriptor_->value_count(); i++)
+                        if (options_.switch_dispatch)
                         {
-                           
-                            vars["name"] = EnumValueName(descriptor_->value(i));
-                            SourceLocation Location;
-                            descriptor_->value(i)->GetSourceLocation(&Location);
-                            vars["nameoption"] = Location.trailing_comments;
-                            string comment = Location.trailing_comments;
-                            vector<string> splitResult = split(comment, ",", false);
-                            bool FoundRef = false;
-                            for (string s : splitResult)
-                            {
-                                if (starts_with(s, "req="))
-                                {
-                                    s = s.replace(0, 4, "");
-                                    vars["repname"] = s;
-                                    FoundRef = true;
-                                }
-                            }
-                            if (FoundRef)
+                            GenerateDispatch(printer);
+                        }
+                        else
+                        {
+                            printer->Print("TMap<int, TSubclassOf<UResponse>> ResponseMap = \n{\n");
+                            printer->Annotate("classname", descriptor_);
+                            printer->Indent();
+                            for (int i = 0; i < descriptor_->value_count(); i++)
                             {
-                                if (ends_with(EnumValueName(descriptor_->value(i)), "_PUSH"))
+                           
+                                vars["name"] = EnumValueName(descriptor_->value(i));
+                                SourceLocation Location;
+                                descriptor_->value(i)->GetSourceLocation(&Location);
+                                vars["nameoption"] = Location.trailing_comments;
+                                string comment = Location.trailing_comments;
+                                vector<string> splitResult = split(comment, ",", false);
+                                bool FoundRef = false;
+                                for (string s : splitResult)
                                 {
-                                    printer->Print(vars, "{$name$, U$repname$Push::StaticClass() }");
+                                    if (starts_with(s, "req="))
+                                    {
+                                        s = s.replace(0, 4, "");
+                                        vars["repname"] = s;
+                                        FoundRef = true;
+                                    }
                                 }
-                                else
+                                if (FoundRef)
                                 {
-                                    printer->Print(vars, "{$name$, U$repname$Resp::StaticClass() }");
-                                }
+                                    if (ends_with(EnumValueName(descriptor_->value(i)), "_PUSH"))
+                                    {
+                                        printer->Print(vars, "{$name$, U$repname$Push::StaticClass() }");
+                                    }
+                                    else
+                                    {
+                                        printer->Print(vars, "{$name$, U$repname$Resp::StaticClass() }");
+                                    }
 
-                                printer->Print(",");
-                                printer->Print(vars, " //$nameoption$");
+                                    printer->Print(",");
+                                    printer->Print(vars, " //$nameoption$");
+                                }
                             }
+                            printer->Outdent();
+                            printer->Print("};\n");
+                        }
+
+                        if (options_.object_pool)
+                        {
+                            GeneratePoolHooks(printer);
                         }
-                        printer->Outdent();
-                        printer->Print("};\n");
 
                         for (int i = 0; i < descriptor_->value_count(); i++)
                         {
@@ -191,6 +204,156 @@ namespace google
                     }
                 }
 
+                // Response class name ("U<req>Resp"/"U<req>Push") a CMD value is
+                // routed to through its "req=" comment, empty when it has none.
+                static string ResponseClassName(const EnumValueDescriptor* value)
+                {
+                    SourceLocation Location;
+                    value->GetSourceLocation(&Location);
+                    vector<string> splitResult = split(Location.trailing_comments, ",", false);
+                    string classname;
+                    for (string s : splitResult)
+                    {
+                        if (starts_with(s, "req="))
+                        {
+                            classname = s.replace(0, 4, "");
+                        }
+                    }
+                    if (classname.empty())
+                    {
+                        return "";
+                    }
+                    return ends_with(EnumValueName(value), "_PUSH") ? "U" + classname + "Push" : "U" + classname + "Resp";
+                }
+
+                // (CMD value name, response class) for every value with a response
+                // class, first value per number only, so they can be switch cases.
+                static vector<std::pair<string, string> > ResponseRoutes(const EnumDescriptor* descriptor)
+                {
+                    vector<std::pair<string, string> > routes;
+                    std::set<int> numbers;
+                    for (int i = 0; i < descriptor->value_count(); i++)
+                    {
+                        const EnumValueDescriptor* value = descriptor->value(i);
+                        const string response = ResponseClassName(value);
+                        if (!response.empty() && numbers.insert(value->number()).second)
+                        {
+                            routes.push_back(std::make_pair(EnumValueName(value), response));
+                        }
+                    }
+                    return routes;
+                }
+
+                // switch_dispatch: a switch the compiler turns into a jump table or
+                // a binary search replaces the per-instance ResponseMap TMap, so
+                // routing neither hashes nor builds anything at startup.
+                void EnumGenerator::GenerateDispatch(io::Printer* printer)
+                {
+                    const vector<std::pair<string, string> > routes = ResponseRoutes(descriptor_);
+                    std::map<string, string> vars;
+                    printer->Print(
+                        "static constexpr bool HasResponseClass(int Cmd)\n"
+                        "{\n"
+                        "    switch (Cmd)\n"
+                        "    {\n");
+                    for (int i = 0; i < routes.size(); i++)
+                    {
+                        vars["name"] = routes[i].first;
+                        printer->Print(vars, "    case $name$:\n");
+                    }
+                    if (!routes.empty())
+                    {
+                        printer->Print("        return true;\n");
+                    }
+                    printer->Print(
+                        "    default:\n"
+                        "        return false;\n"
+                        "    }\n"
+                        "}\n"
+                        "\n"
+                        "// Response class Cmd is routed to, nullptr for unknown commands.\n"
+                        "static UClass* FindResponseClass(int Cmd)\n"
+                        "{\n"
+                        "    switch (Cmd)\n"
+                        "    {\n");
+                    for (int i = 0; i < routes.size(); i++)
+                    {
+                        vars["name"] = routes[i].first;
+                        vars["response"] = routes[i].second;
+                        printer->Print(vars, "    case $name$: return $response$::StaticClass();\n");
+                    }
+                    printer->Print(
+                        "    default: return nullptr;\n"
+                        "    }\n"
+                        "}\n"
+                        "\n"
+                        "static UResponse* NewResponse(int Cmd, UObject* Outer)\n"
+                        "{\n"
+                        "    switch (Cmd)\n"
+                        "    {\n");
+                    for (int i = 0; i < routes.size(); i++)
+                    {
+                        vars["name"] = routes[i].first;
+                        vars["response"] = routes[i].second;
+                        printer->Print(vars, "    case $name$: return NewObject<$response$>(Outer);\n");
+                    }
+                    printer->Print(
+                        "    default: return nullptr;\n"
+                        "    }\n"
+                        "}\n");
+                }
+
+                // object_pool: the dispatcher acquires responses through these
+                // instead of NewObject on the routed class. Delta pushes keep their
+                // state between messages and are not pooled.
+                void EnumGenerator::GeneratePoolHooks(io::Printer* printer)
+                {
+                    vector<std::pair<string, string> > routes;
+                    const vector<std::pair<string, string> > all_routes = ResponseRoutes(descriptor_);
+                    for (int i = 0; i < all_routes.size(); i++)
+                    {
+                        if (!options_.delta_push || !ends_with(all_routes[i].second, "Push"))
+                        {
+                            routes.push_back(all_routes[i]);
+                        }
+                    }
+
+                    std::map<string, string> vars;
+                    printer->Print(
+                        "\n"
+                        "// Pooled response for Cmd, nullptr when Cmd is not pooled.\n"
+                        "static UResponse* AcquireResponse(int Cmd)\n"
+                        "{\n"
+                        "    switch (Cmd)\n"
+                        "    {\n");
+                    for (int i = 0; i < routes.size(); i++)
+                    {
+                        vars["name"] = routes[i].first;
+                        vars["response"] = routes[i].second;
+                        printer->Print(vars, "    case $name$: return $response$::Acquire();\n");
+                    }
+                    printer->Print(
+                        "    default: return nullptr;\n"
+                        "    }\n"
+                        "}\n"
+                        "\n"
+                        "// Returns a response from AcquireResponse(Cmd) to its pool.\n"
+                        "static void ReleaseResponse(int Cmd, UResponse* Response)\n"
+                        "{\n"
+                        "    switch (Cmd)\n"
+                        "    {\n");
+                    for (int i = 0; i < routes.size(); i++)
+                    {
+                        vars["name"] = routes[i].first;
+                        vars["response"] = routes[i].second;
+                        printer->Print(vars, "    case $name$: static_cast<$response$*>(Response)->Release(); break;\n");
+                    }
+                    printer->Print(
+                        "    default: break;\n"
+                        "    }\n"
+                        "}\n");
+                }
+
                 void EnumGenerator::
                 GenerateGetEnumDescriptorSpecializations(io::Printer* printer)
                 {
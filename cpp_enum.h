@@ -77,6 +77,13 @@ class EnumGenerator {
   // nested enums.
   void GenerateDefinition(io::Printer* printer);
 
+  // switch_dispatch: HasResponseClass()/FindResponseClass()/NewResponse()
+  // on UResponseMap instead of the ResponseMap TMap.
+  void GenerateDispatch(io::Printer* printer);
+
+  // object_pool: AcquireResponse()/ReleaseResponse() on UResponseMap.
+  void GeneratePoolHooks(io::Printer* printer);
+
   // Generate specialization of GetEnumDescriptor<MyEnum>().
   // Precondition: in ::google::protobuf namespace.
   void GenerateGetEnumDescriptorSpecializations(io::Printer* printer);
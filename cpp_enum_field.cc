@@ -71,7 +71,7 @@ EnumFieldGenerator::~EnumFieldGenerator() {}
 void EnumFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
   printer->Print(variables_, 
-  "UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
+  "$uproperty$\n"
   "E$type1$ $name$;\n\n");
   //printer->Print(variables_, "int $name$_;\n");
 }
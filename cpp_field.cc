@@ -81,6 +81,8 @@ void SetCommonFieldVariables(const FieldDescriptor* descriptor,
       ? "GOOGLE_PROTOBUF_DEPRECATED_ATTR " : "";
 
   (*variables)["cppget"] = "Get";
+  (*variables)["uproperty"] = UPropertyDeclaration(descriptor, options);
+  (*variables)["allocator"] = InlineAllocator(descriptor);
 
   if (HasFieldPresence(descriptor->file())) {
     (*variables)["set_hasbit"] =
@@ -692,9 +692,40 @@ namespace google
                         "\n"
                         "#pragma once\n"
                         "#include \"Project_X/Utility/APIServer/Public/APIProtocol.h\"\n"
+                        "#include \"Project_X/Utility/APIServer/Public/ProtoUEString.h\"\n",
+                        "filename", file_->name());
+
+                    // Runtime headers only for the options and annotations in
+                    // use, every one of them adds to the compile time of each
+                    // file that includes this header.
+                    const bool wire = options_.direct_parsing || options_.direct_serialization ||
+                        options_.table_driven_parsing || options_.table_driven_serialization;
+                    const struct {
+                        bool used;
+                        const char* header;
+                    } runtime_headers[] = {
+                        { HasLazyStringFields(file_, options_), "ProtoUELazyString.h" },
+                        { options_.arena, "ProtoUEArena.h" },
+                        { wire, "ProtoUEWire.h" },
+                        { options_.table_driven_parsing || options_.table_driven_serialization, "ProtoUETable.h" },
+                        { options_.object_pool, "ProtoUEPool.h" },
+                        { options_.batch_requests, "ProtoUEBatch.h" },
+                        { HasCompressedMessages(file_, options_), "ProtoUECompression.h" },
+                        { HasOneofs(file_, options_), "ProtoUEOneof.h" },
+                        { HasNameFields(file_, options_), "ProtoUEName.h" },
+                        { HasBytesFields(file_, options_), "ProtoUEBytes.h" },
+                    };
+                    for (size_t i = 0; i < sizeof(runtime_headers) / sizeof(runtime_headers[0]); i++)
+                    {
+                        if (runtime_headers[i].used)
+                        {
+                            printer->Print(
+                                "#include \"Project_X/Utility/APIServer/Public/$header$\"\n",
+                                "header", runtime_headers[i].header);
+                        }
+                    }
+                    printer->Print(
                         "#include \"$filename_clean$.pb.h\"\n",
-                        "filename", file_->name(),
-                        "filename_identifier", filename_identifier,
                         "filename_clean", FileName);
 
                     // Generate enum definitions.
@@ -12,6 +12,7 @@
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/descriptor.pb.h>
+#include "strutil.h"
 
 namespace google {
 	namespace protobuf {
@@ -55,6 +56,52 @@ namespace google {
 						else if (options[i].first == "table_driven_serialization") {
 							file_options.table_driven_serialization = true;
 						}
+						else if (options[i].first == "copy_free") {
+							file_options.copy_free_conversion = true;
+						}
+						else if (options[i].first == "reuse_containers") {
+							file_options.reuse_containers = true;
+						}
+						else if (options[i].first == "lazy_strings") {
+							file_options.lazy_strings = true;
+						}
+						else if (options[i].first == "arena") {
+							file_options.arena = true;
+						}
+						else if (options[i].first == "direct_serialization") {
+							file_options.direct_serialization = true;
+						}
+						else if (options[i].first == "direct_parsing") {
+							file_options.direct_parsing = true;
+						}
+						else if (options[i].first == "presence_aware") {
+							file_options.presence_aware = true;
+						}
+						else if (options[i].first == "dirty_tracking") {
+							file_options.dirty_tracking = true;
+						}
+						else if (options[i].first == "delta_push") {
+							file_options.delta_push = true;
+						}
+						else if (options[i].first == "object_pool") {
+							file_options.object_pool = true;
+						}
+						else if (options[i].first == "shared_payload") {
+							file_options.shared_payload = true;
+						}
+						else if (options[i].first == "switch_dispatch") {
+							file_options.switch_dispatch = true;
+						}
+						else if (options[i].first == "batch_requests") {
+							file_options.batch_requests = true;
+						}
+						else if (options[i].first == "compress") {
+							file_options.compress_threshold = options[i].second.empty()
+								? kDefaultCompressThreshold : strto32(options[i].second.c_str(), NULL, 10);
+						}
+						else if (options[i].first == "two_phase_unpack") {
+							file_options.two_phase_unpack = true;
+						}
 						else {
 							*error = "Unknown generator option: " + options[i].first;
 							return false;
@@ -32,8 +32,10 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
+#include <algorithm>
 #include <limits>
 #include <map>
+#include <set>
 #include <vector>
 #include <google/protobuf/stubs/hash.h>
 
@@ -337,6 +339,281 @@ namespace google {
 					return NULL;
 				}
 
+				bool GetFieldAnnotation(const FieldDescriptor* field, const string& key,
+					string* value) {
+					SourceLocation location;
+					if (!field->GetSourceLocation(&location)) {
+						return false;
+					}
+					vector<string> entries = split(location.trailing_comments, ",", false);
+					for (int i = 0; i < entries.size(); i++) {
+						string entry = StringReplace(entries[i], " ", "", true);
+						entry = StringReplace(entry, "\n", "", true);
+						if (entry == key) {
+							if (value != NULL) value->clear();
+							return true;
+						}
+						if (starts_with(entry, key + "=")) {
+							if (value != NULL) *value = entry.substr(key.size() + 1);
+							return true;
+						}
+					}
+					return false;
+				}
+
+				bool GetMessageAnnotation(const Descriptor* message, const string& key,
+					string* value) {
+					SourceLocation location;
+					if (!message->GetSourceLocation(&location)) {
+						return false;
+					}
+					vector<string> lines = split(location.leading_comments, "\n", false);
+					for (int i = 0; i < lines.size(); i++) {
+						vector<string> entries = split(lines[i], ",", false);
+						for (int j = 0; j < entries.size(); j++) {
+							string entry = StringReplace(entries[j], " ", "", true);
+							if (entry == key) {
+								if (value != NULL) value->clear();
+								return true;
+							}
+							if (starts_with(entry, key + "=")) {
+								if (value != NULL) *value = entry.substr(key.size() + 1);
+								return true;
+							}
+						}
+					}
+					return false;
+				}
+
+				int CompressionThreshold(const Descriptor* message, const Options& options) {
+					string value;
+					if (!GetMessageAnnotation(message, "compress", &value)) {
+						return options.compress_threshold;
+					}
+					if (value.empty()) {
+						return options.compress_threshold > 0 ? options.compress_threshold : kDefaultCompressThreshold;
+					}
+					return std::max(0, static_cast<int>(strto32(value.c_str(), NULL, 10)));
+				}
+
+				bool IsLazyStringField(const FieldDescriptor* field, const Options& options) {
+					if (field->is_repeated() || field->containing_oneof() != NULL ||
+						field->type() != FieldDescriptor::TYPE_STRING) {
+						return false;
+					}
+					if (HasFieldAnnotation(field, "fname")) {
+						return false;
+					}
+					if (HasFieldAnnotation(field, "lazy")) {
+						return true;
+					}
+					const string& message_name = field->containing_type()->name();
+					return options.lazy_strings &&
+						(ends_with(message_name, "Resp") || ends_with(message_name, "Push"));
+				}
+
+				bool IsNameStringField(const FieldDescriptor* field) {
+					return !field->is_map() && field->containing_oneof() == NULL &&
+						field->type() == FieldDescriptor::TYPE_STRING &&
+						HasFieldAnnotation(field, "fname");
+				}
+
+				bool HasNameKey(const FieldDescriptor* field) {
+					return field->is_map() &&
+						field->message_type()->FindFieldByName("key")->type() == FieldDescriptor::TYPE_STRING &&
+						HasFieldAnnotation(field, "fname");
+				}
+
+				int InlineCapacity(const FieldDescriptor* field) {
+					string value;
+					if (!field->is_repeated() || field->is_map() ||
+						!GetFieldAnnotation(field, "capacity", &value)) {
+						return 0;
+					}
+					return std::max(0, static_cast<int>(strto32(value.c_str(), NULL, 10)));
+				}
+
+				string InlineAllocator(const FieldDescriptor* field) {
+					const int capacity = InlineCapacity(field);
+					return capacity > 0 ? ", TInlineAllocator<" + SimpleItoa(capacity) + ">" : "";
+				}
+
+				bool IsScalarOnlyMessage(const Descriptor* message) {
+					const string& name = message->name();
+					if (message->field_count() == 0 || ends_with(name, "Req") ||
+						ends_with(name, "Resp") || ends_with(name, "Push")) {
+						return false;
+					}
+					for (int i = 0; i < message->field_count(); i++) {
+						const FieldDescriptor* field = message->field(i);
+						if (field->is_repeated() || field->containing_oneof() != NULL ||
+							field->has_default_value()) {
+							return false;
+						}
+						switch (field->cpp_type()) {
+						case FieldDescriptor::CPPTYPE_STRING:
+						case FieldDescriptor::CPPTYPE_MESSAGE:
+							return false;
+						default:
+							break;
+						}
+					}
+					return true;
+				}
+
+				static bool ContainsOneof(const Descriptor* message, std::set<const Descriptor*>* visited) {
+					if (!visited->insert(message).second) {
+						return false;
+					}
+					if (message->oneof_decl_count() > 0) {
+						return true;
+					}
+					for (int i = 0; i < message->field_count(); i++) {
+						const FieldDescriptor* field = message->field(i);
+						if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+							ContainsOneof(field->message_type(), visited)) {
+							return true;
+						}
+					}
+					return false;
+				}
+
+				bool ContainsOneof(const Descriptor* message) {
+					std::set<const Descriptor*> visited;
+					return ContainsOneof(message, &visited);
+				}
+
+				bool IsBytesViewField(const FieldDescriptor* field, const Options& options) {
+					if (field->is_repeated() || field->containing_oneof() != NULL ||
+						field->type() != FieldDescriptor::TYPE_BYTES ||
+						!HasFieldAnnotation(field, "view")) {
+						return false;
+					}
+					// Without MergeFromWire there is no receive buffer to point into.
+					if (ContainsOneof(field->containing_type())) {
+						return false;
+					}
+					const string& message_name = field->containing_type()->name();
+					if (ends_with(message_name, "Push")) {
+						return options.direct_parsing && !options.table_driven_parsing && !options.delta_push;
+					}
+					return ends_with(message_name, "Resp") && options.direct_parsing && !options.table_driven_parsing;
+				}
+
+				string UnreflectedReason(const FieldDescriptor* field, const Options& options) {
+					if (InlineCapacity(field) > 0) {
+						return "capacity=" + SimpleItoa(InlineCapacity(field));
+					}
+					if (IsBytesViewField(field, options)) {
+						return "bytes view";
+					}
+					const FieldDescriptor* element = field->is_map()
+						? field->message_type()->FindFieldByName("value") : field;
+					if (element->type() == FieldDescriptor::TYPE_BYTES && field->is_repeated()) {
+						return "nested TArray";
+					}
+					return "";
+				}
+
+				bool IsBitCompatibleScalar(const FieldDescriptor* field) {
+					if (!field->is_repeated() || field->is_map()) {
+						return false;
+					}
+					switch (field->cpp_type()) {
+					case FieldDescriptor::CPPTYPE_INT32:
+					case FieldDescriptor::CPPTYPE_INT64:
+					case FieldDescriptor::CPPTYPE_UINT32:
+					case FieldDescriptor::CPPTYPE_UINT64:
+					case FieldDescriptor::CPPTYPE_DOUBLE:
+					case FieldDescriptor::CPPTYPE_FLOAT:
+					case FieldDescriptor::CPPTYPE_BOOL:
+						return true;
+					default:
+						// Enums are stored as int on the wire side, strings and messages
+						// are pointer based.
+						return false;
+					}
+				}
+
+				string UEFieldType(const FieldDescriptor* field, const Options& options) {
+					if (field->is_map()) {
+						const FieldDescriptor* key = field->message_type()->FindFieldByName("key");
+						const FieldDescriptor* val = field->message_type()->FindFieldByName("value");
+						string val_type;
+						switch (val->cpp_type()) {
+						case FieldDescriptor::CPPTYPE_MESSAGE:
+							val_type = "F" + FieldMessageTypeName(val);
+							break;
+						case FieldDescriptor::CPPTYPE_ENUM:
+							val_type = ClassName(val->enum_type(), true);
+							break;
+						case FieldDescriptor::CPPTYPE_STRING:
+							val_type = val->type() == FieldDescriptor::TYPE_BYTES ? "TArray<uint8>" : "FString";
+							break;
+						default:
+							val_type = PrimitiveTypeName(val->cpp_type());
+							break;
+						}
+						const string key_type = HasNameKey(field) ? "FName" : PrimitiveTypeName(key->cpp_type());
+						return "TMap<" + key_type + ", " + val_type + ">";
+					}
+
+					string type;
+					switch (field->cpp_type()) {
+					case FieldDescriptor::CPPTYPE_MESSAGE:
+						type = "F" + FieldMessageTypeName(field);
+						break;
+					case FieldDescriptor::CPPTYPE_ENUM:
+						if (field->is_repeated()) {
+							return "";
+						}
+						type = "E" + ClassName(field->enum_type(), false);
+						break;
+					case FieldDescriptor::CPPTYPE_STRING:
+						if (field->type() == FieldDescriptor::TYPE_BYTES) {
+							type = IsBytesViewField(field, options) ? "TArrayView<const uint8>" : "TArray<uint8>";
+						}
+						else if (IsNameStringField(field)) {
+							type = "FName";
+						}
+						else {
+							type = IsLazyStringField(field, options) ? "FProtoLazyString" : "FString";
+						}
+						break;
+					default:
+						type = PrimitiveTypeName(field->cpp_type());
+						break;
+					}
+					return field->is_repeated() ? "TArray<" + type + InlineAllocator(field) + ">" : type;
+				}
+
+				bool IsDirtyTrackedField(const FieldDescriptor* field, const Options& options) {
+					// Blueprint setters only take types a UPROPERTY can have.
+					return options.dirty_tracking && field->containing_oneof() == NULL &&
+						UnreflectedReason(field, options).empty() &&
+						ends_with(field->containing_type()->name(), "Req") &&
+						!UEFieldType(field, options).empty();
+				}
+
+				string DirtySetterName(const FieldDescriptor* field) {
+					return "Set" + UnderscoresToCamelCase(field->name(), true);
+				}
+
+				string UPropertyDeclaration(const FieldDescriptor* field, const Options& options) {
+					// Reflection only knows the default TArray allocator, no views and
+					// no containers of containers.
+					const string unreflected = UnreflectedReason(field, options);
+					if (!unreflected.empty()) {
+						return "// " + unreflected + ", C++ only.";
+					}
+					// Blueprint writes of a tracked field go through its setter so
+					// they mark the field dirty.
+					const string setter = IsDirtyTrackedField(field, options)
+						? "BlueprintSetter = " + DirtySetterName(field) + ", " : "";
+					return "UPROPERTY(EditAnywhere, BlueprintReadWrite, " + setter +
+						"Category = Example, Meta = (ExposeOnSpawn = true))";
+				}
+
 				const char* DeclaredTypeMethodName(FieldDescriptor::Type type) {
 					switch (type) {
 					case FieldDescriptor::TYPE_INT32: return "Int32";
@@ -564,6 +841,73 @@ namespace google {
 					return false;
 				}
 
+				typedef bool (*MessagePredicate)(const Descriptor* message, const Options& options);
+
+				static bool AnyMessage(const Descriptor* message, MessagePredicate predicate, const Options& options) {
+					if (predicate(message, options)) return true;
+					for (int i = 0; i < message->nested_type_count(); ++i) {
+						if (AnyMessage(message->nested_type(i), predicate, options)) return true;
+					}
+					return false;
+				}
+
+				static bool AnyMessage(const FileDescriptor* file, MessagePredicate predicate, const Options& options) {
+					for (int i = 0; i < file->message_type_count(); ++i) {
+						if (AnyMessage(file->message_type(i), predicate, options)) return true;
+					}
+					return false;
+				}
+
+				static bool HasLazyStringField(const Descriptor* message, const Options& options) {
+					for (int i = 0; i < message->field_count(); ++i) {
+						if (IsLazyStringField(message->field(i), options)) return true;
+					}
+					return false;
+				}
+
+				static bool HasNameField(const Descriptor* message, const Options& /* options */) {
+					for (int i = 0; i < message->field_count(); ++i) {
+						const FieldDescriptor* field = message->field(i);
+						if (IsNameStringField(field) || (field->is_map() && HasNameKey(field))) return true;
+					}
+					return false;
+				}
+
+				static bool HasBytesField(const Descriptor* message, const Options& /* options */) {
+					for (int i = 0; i < message->field_count(); ++i) {
+						if (message->field(i)->type() == FieldDescriptor::TYPE_BYTES) return true;
+					}
+					return false;
+				}
+
+				static bool HasOneof(const Descriptor* message, const Options& /* options */) {
+					return message->oneof_decl_count() > 0;
+				}
+
+				static bool IsCompressed(const Descriptor* message, const Options& options) {
+					return CompressionThreshold(message, options) > 0;
+				}
+
+				bool HasLazyStringFields(const FileDescriptor* file, const Options& options) {
+					return AnyMessage(file, HasLazyStringField, options);
+				}
+
+				bool HasNameFields(const FileDescriptor* file, const Options& options) {
+					return AnyMessage(file, HasNameField, options);
+				}
+
+				bool HasBytesFields(const FileDescriptor* file, const Options& options) {
+					return AnyMessage(file, HasBytesField, options);
+				}
+
+				bool HasOneofs(const FileDescriptor* file, const Options& options) {
+					return AnyMessage(file, HasOneof, options);
+				}
+
+				bool HasCompressedMessages(const FileDescriptor* file, const Options& options) {
+					return AnyMessage(file, IsCompressed, options);
+				}
+
 				bool IsStringOrMessage(const FieldDescriptor* field) {
 					switch (field->cpp_type()) {
 					case FieldDescriptor::CPPTYPE_INT32:
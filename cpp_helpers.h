@@ -145,6 +145,86 @@ string MyStripProto(const string& filename);
 // ridiculous C++ standard defines "<:" to be a synonym for "[".
 const char* PrimitiveTypeName(FieldDescriptor::CppType type);
 
+// Field annotations are written in the trailing comment of a field as a
+// comma separated list of "key" or "key=value" entries, the same way CMD enum
+// values carry "req=" and "file=". Returns true if the key is present and
+// stores its value (empty for a bare key) in *value when value is not NULL.
+bool GetFieldAnnotation(const FieldDescriptor* field, const string& key,
+                        string* value);
+
+inline bool HasFieldAnnotation(const FieldDescriptor* field, const string& key) {
+  return GetFieldAnnotation(field, key, NULL);
+}
+
+// Message annotations use the same syntax in the leading comment of a
+// message, one or more entries per line.
+bool GetMessageAnnotation(const Descriptor* message, const string& key,
+                          string* value);
+
+// Size in bytes from which payloads of message are compressed, 0 when they
+// are not: the "compress" / "compress=<bytes>" message annotation, or else
+// the compress generator option.
+int CompressionThreshold(const Descriptor* message, const Options& options);
+
+// Returns true if the singular string field is generated as FProtoLazyString,
+// either through the "lazy" field annotation or the lazy_strings option on a
+// Resp/Push message.
+bool IsLazyStringField(const FieldDescriptor* field, const Options& options);
+
+// Returns true if the singular or repeated string field is generated as FName
+// (TArray<FName>) through the "fname" field annotation.
+bool IsNameStringField(const FieldDescriptor* field);
+
+// Returns true if the string keys of the map field are generated as FName
+// through the "fname" annotation on the map field.
+bool HasNameKey(const FieldDescriptor* field);
+
+// Element count the "capacity=<N>" annotation reserves inline in the TArray
+// of a repeated field, 0 for heap-backed arrays.
+int InlineCapacity(const FieldDescriptor* field);
+
+// ", TInlineAllocator<N>" for fields with an inline capacity, else "".
+string InlineAllocator(const FieldDescriptor* field);
+
+// Returns true if message or any message reachable through its fields
+// declares a oneof. The wire code and the field table do not describe
+// TOneof members, so such messages convert through protobuf instead.
+bool ContainsOneof(const Descriptor* message);
+
+// Returns true if the singular bytes field is generated as a
+// TArrayView<const uint8> into the parsed buffer through the "view" field
+// annotation. Only Resp/Push structs parsed with direct_parsing (and not
+// table_driven_parsing, not delta pushes) have a buffer to point into.
+bool IsBytesViewField(const FieldDescriptor* field, const Options& options);
+
+// Why the member of field can not be a UPROPERTY (inline allocator, nested
+// TArray, view), or "" when it can.
+string UnreflectedReason(const FieldDescriptor* field, const Options& options);
+
+// Returns true for plain messages (no Req/Resp/Push suffix) whose fields are
+// all singular numbers, bools or enums without an explicit default. Their
+// structs are trivially copyable and zero is their constructed state.
+bool IsScalarOnlyMessage(const Descriptor* message);
+
+// Returns true for repeated scalar fields whose RepeatedField<T> element type
+// has the same size and representation as the TArray<T> element used on the
+// UE side, so the two can be copied with a single memcpy.
+bool IsBitCompatibleScalar(const FieldDescriptor* field);
+
+// Returns the UE type of the member generated for field, or an empty string
+// for fields that have no UE-typed member (repeated enums).
+string UEFieldType(const FieldDescriptor* field, const Options& options);
+
+// Returns true if field gets a dirty bit and a setter, i.e. the
+// dirty_tracking option is on and it belongs to a *Req message.
+bool IsDirtyTrackedField(const FieldDescriptor* field, const Options& options);
+
+// Name of the setter generated for a dirty tracked field, e.g. SetNickName.
+string DirtySetterName(const FieldDescriptor* field);
+
+// The UPROPERTY(...) specifier line printed before the member of field.
+string UPropertyDeclaration(const FieldDescriptor* field, const Options& options);
+
 // Get the declared type name in CamelCase format, as is used e.g. for the
 // methods of WireFormat.  For example, TYPE_INT32 becomes "Int32".
 const char* DeclaredTypeMethodName(FieldDescriptor::Type type);
@@ -210,6 +290,14 @@ bool HasMapFields(const FileDescriptor* file);
 // Does this file have any enum type definitions?
 bool HasEnumDefinitions(const FileDescriptor* file);
 
+// Do any messages of the file use FProtoLazyString, FName, TArray<uint8>
+// bytes, a oneof or compression? Each needs its ProtoUE runtime header.
+bool HasLazyStringFields(const FileDescriptor* file, const Options& options);
+bool HasNameFields(const FileDescriptor* file, const Options& options);
+bool HasBytesFields(const FileDescriptor* file, const Options& options);
+bool HasOneofs(const FileDescriptor* file, const Options& options);
+bool HasCompressedMessages(const FileDescriptor* file, const Options& options);
+
 // Does this file have generated parsing, serialization, and other
 // standard methods for which reflection-based fallback implementations exist?
 inline bool HasGeneratedMethods(const FileDescriptor* file,
@@ -63,7 +63,7 @@ void SetMessageVariables(const FieldDescriptor* descriptor,
       descriptor->message_type()->FindFieldByName("key");
   const FieldDescriptor* val =
       descriptor->message_type()->FindFieldByName("value");
-  (*variables)["key_cpp"] = PrimitiveTypeName(key->cpp_type());
+  (*variables)["key_cpp"] = HasNameKey(descriptor) ? "FName" : PrimitiveTypeName(key->cpp_type());
   switch (val->cpp_type()) {
     case FieldDescriptor::CPPTYPE_MESSAGE:
       (*variables)["val_cpp"] = "F" + FieldMessageTypeName(val);
@@ -73,6 +73,10 @@ void SetMessageVariables(const FieldDescriptor* descriptor,
       (*variables)["val_cpp"] = ClassName(val->enum_type(), true);
       (*variables)["wrapper"] = "EnumEntryWrapper";
       break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      (*variables)["val_cpp"] = val->type() == FieldDescriptor::TYPE_BYTES ? "TArray<uint8>" : "FString";
+      (*variables)["wrapper"] = "EntryWrapper";
+      break;
     default:
       (*variables)["val_cpp"] = PrimitiveTypeName(val->cpp_type());
       (*variables)["wrapper"] = "EntryWrapper";
@@ -115,7 +119,7 @@ MapFieldGenerator::~MapFieldGenerator() {}
 void MapFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
     printer->Print(variables_,
-		"UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
+		"$uproperty$\n"
                    "TMap<$key_cpp$, $val_cpp$> $name$;\n\n");
 }
 
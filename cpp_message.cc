@@ -127,6 +127,19 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
         {
             vars["superclass"] = "URequest";
             vars["append"] = "virtual void Pack() override;\nvirtual CMD GetCmd() override;";
+            if (UsesWireSerializer())
+            {
+                vars["append"] += "\n\nint32 ComputeWireSize() const;\nuint8* SerializeWire(uint8* Target) const;";
+            }
+            if (HasWireTable())
+            {
+                vars["append"] += "\nstatic const ProtoUE::FMessageTable& WireTable();";
+            }
+            if (options_.batch_requests)
+            {
+                vars["append"] += "\n// Appends what Pack() sends, for ProtoUE::FRequestBatch.\nvoid AppendPayload(TArray<uint8>& Out);";
+            }
+            GenerateOneofCaseEnums(printer);
             printer->Print(vars,
                            "UCLASS(Blueprintable)\n"
                            "class U$classname$ : public $superclass$ "
@@ -138,6 +151,14 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
             printer->Indent();
 
             printer->Print(vars, "$append$\n");
+            if (options_.dirty_tracking)
+            {
+                GenerateDirtyTrackingDeclarations(printer);
+            }
+            if (options_.object_pool)
+            {
+                GeneratePoolDeclarations(printer);
+            }
             // Generate private members.
             printer->Outdent();
             printer->Indent();
@@ -152,8 +173,23 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
                 generator.GenerateStaticMembers(printer);
                 generator.GeneratePrivateMembers(printer);
             }
+            GenerateOneofMembers(printer);
 
             printer->Outdent();
+            if (options_.dirty_tracking)
+            {
+                // Everything starts dirty so the first Pack() sends the full message.
+                string all_dirty;
+                for (int i = 0; i < optimized_order_.size() || i == 0; i += 32)
+                {
+                    all_dirty += i == 0 ? "0xFFFFFFFFu" : ", 0xFFFFFFFFu";
+                }
+                printer->Print(
+                    "protected:\n"
+                    "    uint32 DirtyBits[$words$] = { $all_dirty$ };\n"
+                    , "words", SimpleItoa(std::max<int>(1, (optimized_order_.size() + 31) / 32))
+                    , "all_dirty", all_dirty);
+            }
             printer->Print("};\n");
         }
         else if (ends_with(classname_, "Resp") || ends_with(classname_, "Push"))
@@ -161,7 +197,9 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
             vars["superclass"] = "UResponse";
             vars["classname"] = classname_;
             vars["append"] = "void Unpack(const std::string& data) override;\n"
+                "void Unpack(const uint8* Bytes, int32 Size) override;\n"
                 "virtual void Generic_GetDataStruct(void* OutData);\n";
+            GenerateOneofCaseEnums(printer);
             printer->Print(vars,
                            "USTRUCT(BlueprintType)\n"
                            "struct F$classname$Struct : public FResponseDataBase "
@@ -170,6 +208,18 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
             printer->Print("\n");
             printer->Indent();
             printer->Print(vars, "void UnPack($classname$& pbMessage);\n");
+            if (UsesWireParser() && !IsDeltaPush())
+            {
+                printer->Print("bool MergeFromWire(::google::protobuf::io::CodedInputStream* Input);\n");
+            }
+            if (HasWireTable())
+            {
+                printer->Print("static const ProtoUE::FMessageTable& WireTable();\n");
+            }
+            if (HasStructReset())
+            {
+                printer->Print("void Reset();\n");
+            }
 
             printer->Print("\n");
             // Emit some private and static members
@@ -180,6 +230,7 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
                 generator.GenerateStaticMembers(printer);
                 generator.GeneratePrivateMembers(printer);
             }
+            GenerateOneofMembers(printer);
             printer->Outdent();
             printer->Print("};");
             printer->Print("\n");
@@ -193,10 +244,37 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
 
             printer->Indent();
             printer->Print(vars, "$append$\n");
+            if (options_.object_pool && !IsDeltaPush())
+            {
+                GeneratePoolDeclarations(printer);
+            }
+            if (options_.two_phase_unpack && !IsDeltaPush())
+            {
+                printer->Print(vars,
+                    "\n"
+                    "// Phase one, any thread: decodes Bytes into Out without touching UObjects.\n"
+                    "static bool ParseData(const uint8* Bytes, int32 Size, F$classname$Struct& Out);\n"
+                    "// Phase two, game thread: moves a parsed payload into Data and broadcasts\n"
+                    "// OnDataPublished.\n"
+                    "void PublishData(F$classname$Struct&& Parsed);\n"
+                    "FSimpleMulticastDelegate OnDataPublished;\n");
+            }
+            if (options_.shared_payload)
+            {
+                printer->Print(vars,
+                    "\n"
+                    "// Decoded payload shared by every caller until the next Unpack(); it is\n"
+                    "// never modified afterwards and outlives this object while referenced.\n"
+                    "TSharedRef<const F$classname$Struct, ESPMode::ThreadSafe> GetSharedData();\n");
+            }
             printer->Outdent();
             printer->Print("protected:\n");
             printer->Indent();
             printer->Print(vars, "F$classname$Struct Data;\n");
+            if (options_.shared_payload)
+            {
+                printer->Print(vars, "TSharedPtr<const F$classname$Struct, ESPMode::ThreadSafe> SharedData;\n");
+            }
             // Generate private members.
             printer->Outdent();
             // printer->Print("\n");
@@ -213,6 +291,7 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
 
         else
         {
+            GenerateOneofCaseEnums(printer);
             printer->Print(vars,
                            "USTRUCT(BlueprintType)\n"
                            "struct F$classname$"
@@ -224,6 +303,35 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
 
             printer->Print(vars, "void FromPB(const $classname$& pbMessage);\n");
             printer->Print(vars, "void ToPB($classname$& pbMessage) const;\n");
+            if (IsScalarOnlyMessage(descriptor_))
+            {
+                printer->Print(vars,
+                    "// Whole repeated fields at once: Out must have room for Src.size()\n"
+                    "// elements, which are assigned without being constructed first.\n"
+                    "static void FromPBArray(const ::google::protobuf::RepeatedPtrField<$classname$>& Src, F$classname$* Out);\n"
+                    "static void ToPBArray(const F$classname$* Src, int32 Num, ::google::protobuf::RepeatedPtrField<$classname$>* Out);\n");
+            }
+            if (UsesWireParser())
+            {
+                printer->Print("bool MergeFromWire(::google::protobuf::io::CodedInputStream* Input);\n");
+            }
+            if (HasWireTable())
+            {
+                printer->Print("static const ProtoUE::FMessageTable& WireTable();\n");
+            }
+            if (HasStructReset())
+            {
+                printer->Print("void Reset();\n");
+            }
+            if (UsesWireSerializer())
+            {
+                printer->Print(
+                    "\n"
+                    "int32 ComputeWireSize() const;\n"
+                    "uint8* SerializeWire(uint8* Target) const;\n"
+                    "// Set by ComputeWireSize(), read by the parent's SerializeWire().\n"
+                    "mutable int32 CachedWireSize = 0;\n");
+            }
             printer->Print("\n");
             // Emit some private and static members
             for (int i = 0; i < optimized_order_.size(); ++i)
@@ -233,18 +341,91 @@ void UEMessageGenerator::GenerateClassDefinition(io::Printer* printer)
                 generator.GenerateStaticMembers(printer);
                 generator.GeneratePrivateMembers(printer);
             }
+            GenerateOneofMembers(printer);
 
             printer->Outdent();
             printer->Print("};\n");
+            if (IsScalarOnlyMessage(descriptor_))
+            {
+                GenerateScalarOnlyTraits(printer);
+            }
         }
     }
 }
 
+static string WireScalar(const FieldDescriptor* field, const string& value)
+{
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM)
+    {
+        return "static_cast<int>(" + value + ")";
+    }
+    return value;
+}
+
+// Condition under which proto3 serializes a singular field; empty when the
+// field is always written (proto2 fields, sub-messages).
+static string Proto3NonDefaultCheck(const FieldDescriptor* field)
+{
+    if (HasFieldPresence(field->file()) || field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE)
+    {
+        return "";
+    }
+    if (IsNameStringField(field))
+    {
+        return "!" + FieldName(field) + ".IsNone()";
+    }
+    if (field->type() == FieldDescriptor::TYPE_BYTES)
+    {
+        return FieldName(field) + ".Num() != 0";
+    }
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING)
+    {
+        return "!" + FieldName(field) + ".IsEmpty()";
+    }
+    return WireScalar(field, FieldName(field)) + " != 0";
+}
+
+// Value a singular UE member holds when the field is unset.
+static string UEDefaultValue(const FieldDescriptor* field)
+{
+    switch (field->cpp_type())
+    {
+    case FieldDescriptor::CPPTYPE_BOOL:
+        return "false";
+    case FieldDescriptor::CPPTYPE_ENUM:
+        return "static_cast<E" + ClassName(field->enum_type(), false) + ">(0)";
+    case FieldDescriptor::CPPTYPE_STRING:
+        // Strings and TArrays are Reset() instead, this is for FName and views.
+        return IsNameStringField(field) ? "NAME_None" : "{}";
+    default:
+        return "0";
+    }
+}
+
 void UEMessageGenerator::ToPBMessage_Normal(io::Printer* printer, const FieldDescriptor* field)
 {
+    // presence_aware: proto3 leaves default values unset. proto2 still sets
+    // every field, the UE struct does not know which ones were assigned.
+    const string check = options_.presence_aware ? Proto3NonDefaultCheck(field) : "";
+    if (!check.empty())
+    {
+        printer->Print("if ($check$) {\n", "check", check);
+        printer->Indent();
+    }
+
     switch (field->cpp_type())
     {
     case FieldDescriptor::CPPTYPE_MESSAGE:
+        // A heap allocated sub-message handed to an arena message would be
+        // copied again, so arena mode always builds it in place.
+        if (options_.copy_free_conversion || options_.arena)
+        {
+            printer->Print(
+                "$field_name$.ToPB(*pbMessage.mutable_$lowercase_name$());\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
         printer->Print(
             "$field_type$* element = new $field_type$;\n"
             "$field_name$.ToPB(*element);\n"
@@ -254,8 +435,32 @@ void UEMessageGenerator::ToPBMessage_Normal(io::Printer* printer, const FieldDes
             , "lowercase_name", field->lowercase_name());
         break;
     case FieldDescriptor::CPPTYPE_STRING:
+        if (IsLazyStringField(field, options_))
+        {
+            printer->Print(
+                "pbMessage.set_$lowercase_name$($field_name$.GetUtf8());\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
+        if (IsNameStringField(field))
+        {
+            printer->Print(
+                "ProtoUE::FNameToUtf8($field_name$, pbMessage.mutable_$lowercase_name$());\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
+        if (field->type() == FieldDescriptor::TYPE_BYTES)
+        {
+            printer->Print(
+                "ProtoUE::BytesToString($field_name$, pbMessage.mutable_$lowercase_name$());\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
         printer->Print(
-            "pbMessage.set_$lowercase_name$(TCHAR_TO_UTF8(*$field_name$));\n"
+            "ProtoUE::FStringToUtf8($field_name$, pbMessage.mutable_$lowercase_name$());\n"
             , "field_name", FieldName(field)
             , "lowercase_name", field->lowercase_name());
         break;
@@ -275,27 +480,96 @@ void UEMessageGenerator::ToPBMessage_Normal(io::Printer* printer, const FieldDes
     default:
         break;
     }
+
+    if (!check.empty())
+    {
+        printer->Outdent();
+        printer->Print("}\n");
+        if (options_.reuse_containers)
+        {
+            printer->Print(
+                "else {\n"
+                "    pbMessage.clear_$lowercase_name$();\n"
+                "}\n"
+                , "lowercase_name", field->lowercase_name());
+        }
+    }
 }
 
 void UEMessageGenerator::ToPBMessage_Repeated(io::Printer* printer, const FieldDescriptor* field)
 {
+    // In copy-free mode UE structs and strings are visited by const reference
+    // and sub-messages are filled in place through add_$lowercase_name$().
+    const string element = options_.copy_free_conversion ? "const auto& element" : "auto element";
+
+    if (options_.reuse_containers)
+    {
+        printer->Print(
+            "pbMessage.mutable_$lowercase_name$()->Clear();\n"
+            , "lowercase_name", field->lowercase_name());
+    }
+
+    if (IsBitCompatibleScalar(field))
+    {
+        // RepeatedField<T> and TArray<T> share the same contiguous layout.
+        printer->Print(
+            "{\n"
+            "    const int $field_name$Offset = pbMessage.$lowercase_name$_size();\n"
+            "    pbMessage.mutable_$lowercase_name$()->Resize($field_name$Offset + $field_name$.Num(), 0);\n"
+            "    FMemory::Memcpy(pbMessage.mutable_$lowercase_name$()->mutable_data() + $field_name$Offset, $field_name$.GetData(), $field_name$.Num() * sizeof($type$));\n"
+            "}\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name()
+            , "type", PrimitiveTypeName(field->cpp_type()));
+        return;
+    }
+
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE && IsScalarOnlyMessage(field->message_type()))
+    {
+        printer->Print(
+            "F$field_type$::ToPBArray($field_name$.GetData(), $field_name$.Num(), pbMessage.mutable_$lowercase_name$());\n"
+            , "field_name", FieldName(field)
+            , "field_type", ClassName(field->message_type(), false)
+            , "lowercase_name", field->lowercase_name());
+        return;
+    }
+
+    printer->Print(
+        "pbMessage.mutable_$lowercase_name$()->Reserve(pbMessage.$lowercase_name$_size() + $field_name$.Num());\n"
+        , "field_name", FieldName(field)
+        , "lowercase_name", field->lowercase_name());
+
     switch (field->cpp_type())
     {
     case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (options_.copy_free_conversion)
+        {
+            printer->Print(
+                "for ($element$ : $field_name$) {\n"
+                "element.ToPB(*pbMessage.add_$lowercase_name$());\n"
+                "}\n"
+                , "element", element
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
         printer->Print(
-            "for (auto element : $field_name$) {\n"
+            "for ($element$ : $field_name$) {\n"
             "$field_type$ *_$field_type$ = pbMessage.add_$lowercase_name$();\n"
             "element.ToPB(*_$field_type$);\n"
             "}\n"
+            , "element", element
             , "field_name", FieldName(field)
             , "field_type", ClassName(field->message_type(), false)
             , "lowercase_name", field->lowercase_name());
         break;
     case FieldDescriptor::CPPTYPE_STRING:
         printer->Print(
-            "for (auto element : $field_name$) {\n"
-            "pbMessage.add_$lowercase_name$(TCHAR_TO_UTF8(*element));\n"
-            "}\n"
+            field->type() == FieldDescriptor::TYPE_BYTES
+                ? "ProtoUE::BytesArrayToString($field_name$, pbMessage.mutable_$lowercase_name$());\n"
+                : IsNameStringField(field)
+                ? "ProtoUE::FNameArrayToUtf8($field_name$, pbMessage.mutable_$lowercase_name$());\n"
+                : "ProtoUE::FStringArrayToUtf8($field_name$, pbMessage.mutable_$lowercase_name$());\n"
             , "field_name", FieldName(field)
             , "lowercase_name", field->lowercase_name());
         break;
@@ -326,51 +600,68 @@ void UEMessageGenerator::ToPBMessage_Map(io::Printer* printer, const FieldDescri
     const FieldDescriptor* valDescriptor =
         field->message_type()->FindFieldByName("value");
 
-    printer->Print(
-        "for (auto& element : $field_name$) {\n"
-        , "field_name", FieldName(field)
-    );
-
-    ToPBMessage_MapPair(printer, keyDescriptor, "Key");
-    ToPBMessage_MapPair(printer, valDescriptor, "Value");
+    // google::protobuf::Map has no reserve(), so only the reuse mode touches the
+    // destination up front.
+    if (options_.reuse_containers)
+    {
+        printer->Print(
+            "pbMessage.mutable_$lowercase_name$()->clear();\n"
+            , "lowercase_name", field->lowercase_name());
+    }
 
+    // Every value is written straight into the slot owned by the protobuf map.
+    // A string key is transcoded into one buffer reused for all entries.
+    const bool string_key = keyDescriptor->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+    if (string_key)
+    {
+        printer->Print(
+            "{\n"
+            "std::string $field_name$Key;\n"
+            , "field_name", FieldName(field));
+    }
     printer->Print(
-        "(*pbMessage.mutable_$field_name$())[key] = value;\n"
-        "}\n\n", "field_name", FieldName(field)
-    );
+        "for (const auto& element : $field_name$) {\n"
+        , "field_name", FieldName(field));
+    ToPBMessage_MapPair(printer, field, keyDescriptor, valDescriptor);
+    printer->Print("}\n");
+    if (string_key)
+    {
+        printer->Print("}\n");
+    }
+    printer->Print("\n");
 }
 
-void UEMessageGenerator::ToPBMessage_MapPair(io::Printer* printer, const FieldDescriptor* field, const std::string part)
+void UEMessageGenerator::ToPBMessage_MapPair(io::Printer* printer, const FieldDescriptor* field,
+    const FieldDescriptor* key, const FieldDescriptor* value)
 {
-    switch (field->cpp_type())
+    std::map<string, string> vars;
+    vars["lowercase_name"] = field->lowercase_name();
+    // Map keys are integral, bool or string; sint/fixed keys share the
+    // integral cpp types, so they need no conversion.
+    vars["key"] = "element.Key";
+    if (key->cpp_type() == FieldDescriptor::CPPTYPE_STRING)
+    {
+        vars["key"] = FieldName(field) + "Key";
+        printer->Print(vars, HasNameKey(field)
+            ? "ProtoUE::FNameToUtf8(element.Key, &$key$);\n"
+            : "ProtoUE::FStringToUtf8(element.Key, &$key$);\n");
+    }
+
+    switch (value->cpp_type())
     {
     case FieldDescriptor::CPPTYPE_MESSAGE:
-        printer->Print(
-            "$field_type$ $field_name$;\n"
-            "element.$field_part$.ToPB($field_name$);\n"
-            , "field_name", FieldName(field)
-            , "field_part", part
-            , "field_type", ClassName(field->message_type(), false));
+        printer->Print(vars,
+            "element.Value.ToPB((*pbMessage.mutable_$lowercase_name$())[$key$]);\n");
         break;
     case FieldDescriptor::CPPTYPE_STRING:
-        printer->Print(
-            "std::string $field_name$ = TCHAR_TO_UTF8(*element.$field_part$);\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
-    case FieldDescriptor::CPPTYPE_INT32:
-        printer->Print(
-            "int32 $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
-    case FieldDescriptor::CPPTYPE_BOOL:
-        printer->Print(
-            "bool $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
+        printer->Print(vars, value->type() == FieldDescriptor::TYPE_BYTES
+            ? "ProtoUE::BytesToString(element.Value, &(*pbMessage.mutable_$lowercase_name$())[$key$]);\n"
+            : "ProtoUE::FStringToUtf8(element.Value, &(*pbMessage.mutable_$lowercase_name$())[$key$]);\n");
         break;
     default:
+        // Scalars and enums: the TMap value already has the protobuf type.
+        printer->Print(vars,
+            "(*pbMessage.mutable_$lowercase_name$())[$key$] = element.Value;\n");
         break;
     }
 }
@@ -380,6 +671,20 @@ void UEMessageGenerator::ToPBMessage(io::Printer* printer)
     for (int i = 0; i < descriptor_->field_count(); i++)
     {
         const FieldDescriptor* field = descriptor_->field(i);
+        if (field->containing_oneof() != NULL)
+        {
+            if (field == field->containing_oneof()->field(0))
+            {
+                ToPBOneof(printer, field->containing_oneof());
+            }
+            continue;
+        }
+        const string dirty = DirtyBitCheck(field);
+        if (!dirty.empty())
+        {
+            printer->Print("if ($dirty$) {\n", "dirty", dirty);
+            printer->Indent();
+        }
         if (field->is_map())
         {
             ToPBMessage_Map(printer, field);
@@ -392,14 +697,174 @@ void UEMessageGenerator::ToPBMessage(io::Printer* printer)
         {
             ToPBMessage_Normal(printer, field);
         }
+        if (!dirty.empty())
+        {
+            printer->Outdent();
+            printer->Print("}\n");
+        }
+    }
+}
+
+string UEMessageGenerator::DirtyBitCheck(const FieldDescriptor* field)
+{
+    if (!IsDirtyTrackedField(field, options_))
+    {
+        return "";
+    }
+    const int bit = std::find(optimized_order_.begin(), optimized_order_.end(), field) - optimized_order_.begin();
+    return "(DirtyBits[" + SimpleItoa(bit / 32) + "] & " + DirtyBitMask(bit) + ") != 0";
+}
+
+string UEMessageGenerator::DirtyBitMask(int bit)
+{
+    return StrCat("0x", strings::Hex(1u << (bit % 32), strings::ZERO_PAD_8), "u");
+}
+
+void UEMessageGenerator::GenerateDirtyTrackingDeclarations(io::Printer* printer)
+{
+    printer->Print(
+        "\n"
+        "// Pack() only sends the fields changed since the last MarkClean().\n"
+        "UFUNCTION(BlueprintCallable, Category = Example)\n"
+        "void MarkClean();\n"
+        "UFUNCTION(BlueprintCallable, Category = Example)\n"
+        "void MarkAllDirty();\n"
+        "// For C++ code that modifies a member in place instead of calling its setter.\n"
+        "UFUNCTION(BlueprintCallable, Category = Example)\n"
+        "void MarkFieldDirty(int32 FieldNumber);\n"
+        "\n");
+    for (int i = 0; i < optimized_order_.size(); ++i)
+    {
+        const FieldDescriptor* field = optimized_order_[i];
+        if (!IsDirtyTrackedField(field, options_))
+        {
+            continue;
+        }
+        printer->Print(
+            "UFUNCTION(BlueprintSetter)\n"
+            "void $setter$($param$);\n"
+            , "setter", DirtySetterName(field)
+            , "param", DirtySetterParam(field));
+    }
+}
+
+string UEMessageGenerator::DirtySetterParam(const FieldDescriptor* field)
+{
+    const string type = UEFieldType(field, options_);
+    const bool by_value = !field->is_repeated()
+        && field->cpp_type() != FieldDescriptor::CPPTYPE_STRING
+        && field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE;
+    return by_value ? type + " InValue" : "const " + type + "& InValue";
+}
+
+void UEMessageGenerator::GenerateDirtyTrackingMethods(io::Printer* printer)
+{
+    printer->Print(
+        "void U$classname$::MarkClean()\n"
+        "{\n"
+        "    FMemory::Memzero(DirtyBits, sizeof(DirtyBits));\n"
+        "}\n"
+        "\n"
+        "void U$classname$::MarkAllDirty()\n"
+        "{\n"
+        "    FMemory::Memset(DirtyBits, 0xFF, sizeof(DirtyBits));\n"
+        "}\n"
+        "\n"
+        "void U$classname$::MarkFieldDirty(int32 FieldNumber)\n"
+        "{\n"
+        "    switch (FieldNumber)\n"
+        "    {\n"
+        , "classname", classname_);
+    printer->Indent();
+    for (int i = 0; i < optimized_order_.size(); ++i)
+    {
+        const FieldDescriptor* field = optimized_order_[i];
+        if (!IsDirtyTrackedField(field, options_))
+        {
+            continue;
+        }
+        printer->Print(
+            "case $number$:\n"
+            "    DirtyBits[$word$] |= $mask$;\n"
+            "    break;\n"
+            , "number", SimpleItoa(field->number())
+            , "word", SimpleItoa(i / 32)
+            , "mask", DirtyBitMask(i));
+    }
+    printer->Outdent();
+    printer->Print(
+        "    default:\n"
+        "        break;\n"
+        "    }\n"
+        "}\n"
+        "\n");
+
+    for (int i = 0; i < optimized_order_.size(); ++i)
+    {
+        const FieldDescriptor* field = optimized_order_[i];
+        if (!IsDirtyTrackedField(field, options_))
+        {
+            continue;
+        }
+        std::map<string, string> vars;
+        vars["classname"] = classname_;
+        vars["setter"] = DirtySetterName(field);
+        vars["param"] = DirtySetterParam(field);
+        vars["field_name"] = FieldName(field);
+        vars["word"] = SimpleItoa(i / 32);
+        vars["mask"] = DirtyBitMask(i);
+        printer->Print(vars,
+            "void U$classname$::$setter$($param$)\n"
+            "{\n");
+        // Status syncs tend to set every field each tick, assigning an equal
+        // scalar or string must not make it dirty.
+        if (!field->is_repeated() && field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE
+            && !IsLazyStringField(field, options_))
+        {
+            printer->Print(vars,
+                field->type() == FieldDescriptor::TYPE_STRING && !IsNameStringField(field)
+                    ? "    if ($field_name$.Equals(InValue, ESearchCase::CaseSensitive))\n"
+                    : "    if ($field_name$ == InValue)\n");
+            printer->Print(
+                "    {\n"
+                "        return;\n"
+                "    }\n");
+        }
+        printer->Print(vars,
+            "    $field_name$ = InValue;\n"
+            "    DirtyBits[$word$] |= $mask$;\n"
+            "}\n"
+            "\n");
     }
 }
 
-void UEMessageGenerator::FromPBMessage_Normal(io::Printer* printer, const FieldDescriptor* field)
+void UEMessageGenerator::FromPBMessage_Normal(io::Printer* printer, const FieldDescriptor* field, bool reuse_containers)
 {
+    // presence_aware: with has-bits only the fields present in the message
+    // are converted. Fields with an explicit [default = ...] are always
+    // assigned since the UE member does not carry that default. proto3 needs
+    // no check here, an empty string or a zero scalar is already O(1).
+    const bool check = options_.presence_aware && HasFieldPresence(field->file())
+        && field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE && !field->has_default_value();
+    if (check)
+    {
+        printer->Print("if (pbMessage.has_$lowercase_name$()) {\n", "lowercase_name", field->lowercase_name());
+        printer->Indent();
+    }
+
     switch (field->cpp_type())
     {
     case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (options_.copy_free_conversion)
+        {
+            printer->Print(
+                "if (pbMessage.has_$lowercase_name$()) {\n"
+                "	$field_name$.FromPB(pbMessage.$lowercase_name$());\n"
+                "}\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
         printer->Print(
             "if (pbMessage.has_$lowercase_name$()) {\n"
             "Dolphin::Protocol::$field_type$ data = pbMessage.$lowercase_name$();\n"
@@ -412,8 +877,41 @@ void UEMessageGenerator::FromPBMessage_Normal(io::Printer* printer, const FieldD
         break;
 
     case FieldDescriptor::CPPTYPE_STRING:
+        if (IsLazyStringField(field, options_))
+        {
+            // Resp/Push UnPack receives a mutable message, so the bytes can be
+            // taken over without a copy.
+            const bool mutable_source = ends_with(classname_, "Resp") || ends_with(classname_, "Push");
+            printer->Print(
+                mutable_source
+                    ? "$field_name$.SetUtf8(MoveTemp(*pbMessage.mutable_$lowercase_name$()));\n"
+                    : "$field_name$.SetUtf8(pbMessage.$lowercase_name$());\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
+        if (IsBytesViewField(field, options_))
+        {
+            // Only valid while pbMessage is, Unpack() itself fills it from the
+            // wire buffer.
+            printer->Print(
+                "$field_name$ = ProtoUE::BytesView(pbMessage.$lowercase_name$());\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
+        if (field->type() == FieldDescriptor::TYPE_BYTES)
+        {
+            printer->Print(
+                "ProtoUE::StringToBytes(pbMessage.$lowercase_name$(), $field_name$);\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            break;
+        }
         printer->Print(
-            "$field_name$ = UTF8_TO_TCHAR(pbMessage.$lowercase_name$().c_str());\n"
+            IsNameStringField(field)
+                ? "$field_name$ = ProtoUE::Utf8ToFName(pbMessage.$lowercase_name$());\n"
+                : "ProtoUE::Utf8ToFString(pbMessage.$lowercase_name$(), $field_name$);\n"
             , "field_name", FieldName(field)
             , "lowercase_name", field->lowercase_name());
         break;
@@ -435,21 +933,98 @@ void UEMessageGenerator::FromPBMessage_Normal(io::Printer* printer, const FieldD
             , "field_name", FieldName(field)
             , "lowercase_name", field->lowercase_name()
             , "EnumName", ClassName(field->enum_type(), false));
+        break;
     default:
         break;
     }
+
+    if (check)
+    {
+        printer->Outdent();
+        printer->Print("}\n");
+        // A refilled struct must not keep the previous value of an absent field.
+        if (reuse_containers)
+        {
+            printer->Print(
+                field->cpp_type() == FieldDescriptor::CPPTYPE_STRING && !IsNameStringField(field)
+                    && !IsBytesViewField(field, options_)
+                    ? "else {\n"
+                      "    $field_name$.Reset();\n"
+                      "}\n"
+                    : "else {\n"
+                      "    $field_name$ = $default$;\n"
+                      "}\n"
+                , "field_name", FieldName(field)
+                , "default", UEDefaultValue(field));
+        }
+    }
 }
 
-void UEMessageGenerator::FromPBMessage_Repeated(io::Printer* printer, const FieldDescriptor* field)
+void UEMessageGenerator::FromPBMessage_Repeated(io::Printer* printer, const FieldDescriptor* field, bool reuse_containers)
 {
+    // Size the TArray once from the source. Reset() keeps the allocation of a
+    // struct that is being refilled.
+    printer->Print(
+        reuse_containers
+            ? "$field_name$.Reset(pbMessage.$lowercase_name$_size());\n"
+            : "$field_name$.Reserve($field_name$.Num() + pbMessage.$lowercase_name$_size());\n"
+        , "field_name", FieldName(field)
+        , "lowercase_name", field->lowercase_name());
+
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING)
+    {
+        printer->Print(
+            field->type() == FieldDescriptor::TYPE_BYTES
+                ? "ProtoUE::StringArrayToBytes(pbMessage.$lowercase_name$(), $field_name$);\n"
+                : IsNameStringField(field)
+                ? "ProtoUE::Utf8ToFNameArray(pbMessage.$lowercase_name$(), $field_name$);\n"
+                : "ProtoUE::Utf8ToFStringArray(pbMessage.$lowercase_name$(), $field_name$);\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name());
+        return;
+    }
+
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE && IsScalarOnlyMessage(field->message_type()))
+    {
+        printer->Print(
+            "{\n"
+            "    const int32 $field_name$Offset = $field_name$.AddUninitialized(pbMessage.$lowercase_name$_size());\n"
+            "    F$field_type$::FromPBArray(pbMessage.$lowercase_name$(), $field_name$.GetData() + $field_name$Offset);\n"
+            "}\n"
+            , "field_name", FieldName(field)
+            , "field_type", ClassName(field->message_type(), false)
+            , "lowercase_name", field->lowercase_name());
+        return;
+    }
+
+    if (IsBitCompatibleScalar(field))
+    {
+        // RepeatedField<T> and TArray<T> share the same contiguous layout.
+        printer->Print(
+            "$field_name$.Append(reinterpret_cast<const $type$*>(pbMessage.$lowercase_name$().data()), pbMessage.$lowercase_name$_size());\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name()
+            , "type", PrimitiveTypeName(field->cpp_type()));
+        return;
+    }
+
     printer->Print(
-        "for (auto element : pbMessage.$lowercase_name$()) {\n"
+        "for ($element$ : pbMessage.$lowercase_name$()) {\n"
+        , "element", options_.copy_free_conversion ? "const auto& element" : "auto element"
         , "lowercase_name", field->lowercase_name());
 
 
     switch (field->cpp_type())
     {
     case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (options_.copy_free_conversion)
+        {
+            // Construct the UE struct in the array slot instead of copying a temporary in.
+            printer->Print(
+                "$field_name$[$field_name$.AddDefaulted()].FromPB(element);\n"
+                , "field_name", FieldName(field));
+            break;
+        }
         printer->Print(
             "F$field_type$ _$field_type$;\n"
             "_$field_type$.FromPB(element);\n"
@@ -458,14 +1033,6 @@ void UEMessageGenerator::FromPBMessage_Repeated(io::Printer* printer, const Fiel
             , "field_type", ClassName(field->message_type(), false)
             , "lowercase_name", field->lowercase_name());
         break;
-    case FieldDescriptor::CPPTYPE_STRING:
-        printer->Print(
-            "$field_type$ _$field_type$ = UTF8_TO_TCHAR(element.c_str());\n"
-            "$field_name$.Add(_$field_type$);\n"
-            , "field_name", FieldName(field)
-            , "lowercase_name", field->lowercase_name()
-            , "field_type", PrimitiveTypeName(field->cpp_type()));
-        break;
     case FieldDescriptor::CPPTYPE_INT32:
     case FieldDescriptor::CPPTYPE_INT64:
     case FieldDescriptor::CPPTYPE_UINT64:
@@ -486,110 +1053,1524 @@ void UEMessageGenerator::FromPBMessage_Repeated(io::Printer* printer, const Fiel
     printer->Print("}\n");
 }
 
-void UEMessageGenerator::FromPBMessage_Map(io::Printer* printer, const FieldDescriptor* field)
+void UEMessageGenerator::FromPBMessage_Map(io::Printer* printer, const FieldDescriptor* field, bool reuse_containers)
 {
     const FieldDescriptor* keyDescriptor =
         field->message_type()->FindFieldByName("key");
     const FieldDescriptor* valDescriptor =
         field->message_type()->FindFieldByName("value");
 
+    if (reuse_containers)
+    {
+        printer->Print(
+            "$field_name$.Reset();\n"
+            "$field_name$.Reserve(pbMessage.$lowercase_name$_size());\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name());
+    }
+    else
+    {
+        printer->Print(
+            "$field_name$.Reserve($field_name$.Num() + pbMessage.$lowercase_name$_size());\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name());
+    }
     printer->Print(
-        "for (auto& element : pbMessage.$lowercase_name$()) {\n"
+        "for (const auto& element : pbMessage.$lowercase_name$()) {\n"
         , "lowercase_name", field->lowercase_name());
-
-    FromPBMessage_MapPair(printer, keyDescriptor, "first");
-    FromPBMessage_MapPair(printer, valDescriptor, "second");
-
-    printer->Print(
-        "$field_name$.Add(key,value);\n"
-        "}\n\n", "field_name", FieldName(field)
-    );
+    FromPBMessage_MapPair(printer, field, keyDescriptor, valDescriptor);
+    printer->Print("}\n\n");
 }
 
-void UEMessageGenerator::FromPBMessage_MapPair(io::Printer* printer, const FieldDescriptor* field, const std::string part)
+void UEMessageGenerator::FromPBMessage_MapPair(io::Printer* printer, const FieldDescriptor* field,
+    const FieldDescriptor* key, const FieldDescriptor* value)
 {
-    switch (field->cpp_type())
+    std::map<string, string> vars;
+    vars["field_name"] = FieldName(field);
+    // Key and value are built directly in the TMap slot; a string key is
+    // transcoded into a temporary that Emplace moves from.
+    vars["key"] = "element.first";
+    if (HasNameKey(field))
+    {
+        vars["key"] = "ProtoUE::Utf8ToFName(element.first)";
+    }
+    else if (key->cpp_type() == FieldDescriptor::CPPTYPE_STRING)
+    {
+        vars["key"] = "ProtoUE::ToFString(element.first)";
+    }
+
+    switch (value->cpp_type())
     {
     case FieldDescriptor::CPPTYPE_MESSAGE:
-        printer->Print(
-            "F$field_type$ $field_name$;\n"
-            "$field_name$.FromPB(element.$field_part$);\n"
-            , "field_name", FieldName(field)
-            , "field_part", part
-            , "field_type", ClassName(field->message_type(), false));
+        printer->Print(vars, "$field_name$.Emplace($key$).FromPB(element.second);\n");
         break;
     case FieldDescriptor::CPPTYPE_STRING:
-        printer->Print(
-            "$field_type$ $field_name$(element.$field_part$.c_str());\n"
-            , "field_name", FieldName(field),
-            "field_part", part
-            , "field_type", PrimitiveTypeName(field->cpp_type()));
+        printer->Print(vars, value->type() == FieldDescriptor::TYPE_BYTES
+            ? "ProtoUE::StringToBytes(element.second, $field_name$.Emplace($key$));\n"
+            : "ProtoUE::Utf8ToFString(element.second, $field_name$.Emplace($key$));\n");
         break;
-    case FieldDescriptor::CPPTYPE_INT32:
-        printer->Print(
-            "int32 $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
+    default:
+        // Scalars and enums: the TMap value already has the protobuf type.
+        printer->Print(vars, "$field_name$.Emplace($key$, element.second);\n");
         break;
-    case FieldDescriptor::CPPTYPE_INT64:
+    }
+}
+
+void UEMessageGenerator::FromPBMessage(io::Printer* printer)
+{
+    for (int i = 0; i < descriptor_->field_count(); i++)
+    {
+        const FieldDescriptor* field = descriptor_->field(i);
+        if (field->containing_oneof() != NULL)
+        {
+            if (field == field->containing_oneof()->field(0))
+            {
+                FromPBOneof(printer, field->containing_oneof(), false);
+            }
+            continue;
+        }
+        if (field->is_map())
+        {
+            FromPBMessage_Map(printer, field, options_.reuse_containers);
+        }
+        else if (field->is_repeated())
+        {
+            FromPBMessage_Repeated(printer, field, options_.reuse_containers);
+        }
+        else
+        {
+            FromPBMessage_Normal(printer, field, options_.reuse_containers);
+        }
+    }
+}
+
+// A oneof becomes a ProtoUE::TOneof member named after it, with one
+// alternative per field in declaration order; case i + 1 is field(i).
+static string OneofMemberName(const OneofDescriptor* oneof)
+{
+    return UnderscoresToCamelCase(oneof->name(), true);
+}
+
+static string OneofCaseEnumName(const string& classname, const OneofDescriptor* oneof)
+{
+    return "E" + classname + OneofMemberName(oneof) + "Case";
+}
+
+void UEMessageGenerator::GenerateOneofCaseEnums(io::Printer* printer)
+{
+    for (int i = 0; i < descriptor_->oneof_decl_count(); i++)
+    {
+        const OneofDescriptor* oneof = descriptor_->oneof_decl(i);
         printer->Print(
-            "int64 $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
-    case FieldDescriptor::CPPTYPE_FLOAT:
+            "enum class $case_enum$ : uint8\n"
+            "{\n"
+            "    None = 0,\n"
+            , "case_enum", OneofCaseEnumName(classname_, oneof));
+        for (int j = 0; j < oneof->field_count(); j++)
+        {
+            printer->Print(
+                "    $name$ = $case$,\n"
+                , "name", UnderscoresToCamelCase(oneof->field(j)->name(), true)
+                , "case", SimpleItoa(j + 1));
+        }
+        printer->Print("};\n\n");
+    }
+}
+
+void UEMessageGenerator::GenerateOneofMembers(io::Printer* printer)
+{
+    for (int i = 0; i < descriptor_->oneof_decl_count(); i++)
+    {
+        const OneofDescriptor* oneof = descriptor_->oneof_decl(i);
+        std::map<string, string> vars;
+        vars["member"] = OneofMemberName(oneof);
+        vars["case_enum"] = OneofCaseEnumName(classname_, oneof);
+        vars["oneof_name"] = oneof->name();
+        string types;
+        for (int j = 0; j < oneof->field_count(); j++)
+        {
+            types += (j == 0 ? "" : ", ") + UEFieldType(oneof->field(j), options_);
+        }
+        vars["types"] = types;
+
+        // Not reflected: UPROPERTY cannot describe a union, so the members are
+        // reachable from C++ only.
+        printer->Print(vars,
+            "\n"
+            "// oneof $oneof_name$, at most one member is set.\n"
+            "ProtoUE::TOneof<$types$> $member$;\n"
+            "$case_enum$ Get$member$Case() const { return static_cast<$case_enum$>($member$.GetCase()); }\n");
+        for (int j = 0; j < oneof->field_count(); j++)
+        {
+            vars["name"] = UnderscoresToCamelCase(oneof->field(j)->name(), true);
+            vars["type"] = UEFieldType(oneof->field(j), options_);
+            vars["case"] = SimpleItoa(j + 1);
+            printer->Print(vars,
+                "const $type$* Find$name$() const { return $member$.Find<$case$>(); }\n"
+                "$type$* Find$name$() { return $member$.Find<$case$>(); }\n"
+                "$type$& Emplace$name$() { return $member$.Emplace<$case$>(); }\n");
+        }
+    }
+}
+
+void UEMessageGenerator::FromPBOneof(io::Printer* printer, const OneofDescriptor* oneof, bool delta)
+{
+    std::map<string, string> vars;
+    vars["classname"] = classname_;
+    vars["member"] = OneofMemberName(oneof);
+    vars["oneof_name"] = oneof->name();
+    printer->Print(vars, "switch (pbMessage.$oneof_name$_case()) {\n");
+    for (int i = 0; i < oneof->field_count(); i++)
+    {
+        const FieldDescriptor* field = oneof->field(i);
+        vars["case"] = SimpleItoa(i + 1);
+        vars["case_name"] = "k" + UnderscoresToCamelCase(field->name(), true);
+        vars["lowercase_name"] = field->lowercase_name();
+        printer->Print(vars, "case $classname$::$case_name$:\n");
+        switch (field->cpp_type())
+        {
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+            printer->Print(vars, "    $member$.Emplace<$case$>().FromPB(pbMessage.$lowercase_name$());\n");
+            break;
+        case FieldDescriptor::CPPTYPE_STRING:
+            printer->Print(vars, field->type() == FieldDescriptor::TYPE_BYTES
+                ? "    ProtoUE::StringToBytes(pbMessage.$lowercase_name$(), $member$.Emplace<$case$>());\n"
+                : "    ProtoUE::Utf8ToFString(pbMessage.$lowercase_name$(), $member$.Emplace<$case$>());\n");
+            break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+            vars["enum_type"] = "E" + ClassName(field->enum_type(), false);
+            printer->Print(vars, "    $member$.Emplace<$case$>(static_cast<$enum_type$>(pbMessage.$lowercase_name$()));\n");
+            break;
+        default:
+            printer->Print(vars, "    $member$.Emplace<$case$>(pbMessage.$lowercase_name$());\n");
+            break;
+        }
+        printer->Print("    break;\n");
+    }
+    printer->Print(
+        delta
+            ? "default:\n"
+              "    break;\n"
+              "}\n"
+            : "default:\n"
+              "    $member$.Reset();\n"
+              "    break;\n"
+              "}\n"
+        , "member", vars["member"]);
+}
+
+void UEMessageGenerator::ToPBOneof(io::Printer* printer, const OneofDescriptor* oneof)
+{
+    std::map<string, string> vars;
+    vars["member"] = OneofMemberName(oneof);
+    vars["oneof_name"] = oneof->name();
+    printer->Print(vars, "switch ($member$.GetCase()) {\n");
+    for (int i = 0; i < oneof->field_count(); i++)
+    {
+        const FieldDescriptor* field = oneof->field(i);
+        vars["case"] = SimpleItoa(i + 1);
+        vars["lowercase_name"] = field->lowercase_name();
+        printer->Print(vars, "case $case$:\n");
+        switch (field->cpp_type())
+        {
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+            printer->Print(vars, "    $member$.Find<$case$>()->ToPB(*pbMessage.mutable_$lowercase_name$());\n");
+            break;
+        case FieldDescriptor::CPPTYPE_STRING:
+            printer->Print(vars, field->type() == FieldDescriptor::TYPE_BYTES
+                ? "    ProtoUE::BytesToString(*$member$.Find<$case$>(), pbMessage.mutable_$lowercase_name$());\n"
+                : "    ProtoUE::FStringToUtf8(*$member$.Find<$case$>(), pbMessage.mutable_$lowercase_name$());\n");
+            break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+            vars["enum_type"] = ClassName(field->enum_type(), true);
+            printer->Print(vars, "    pbMessage.set_$lowercase_name$(static_cast<$enum_type$>(*$member$.Find<$case$>()));\n");
+            break;
+        default:
+            printer->Print(vars, "    pbMessage.set_$lowercase_name$(*$member$.Find<$case$>());\n");
+            break;
+        }
+        printer->Print("    break;\n");
+    }
+    printer->Print(vars,
+        "default:\n"
+        "    pbMessage.clear_$oneof_name$();\n"
+        "    break;\n"
+        "}\n");
+}
+
+void UEMessageGenerator::GenerateScalarOnlyTraits(io::Printer* printer)
+{
+    // Zero is the constructed state and nothing needs destroying, so UE
+    // containers and reflection may memzero, memcpy and skip destructors.
+    printer->Print(
+        "\n"
+        "template<>\n"
+        "struct TStructOpsTypeTraits<F$classname$> : public TStructOpsTypeTraitsBase2<F$classname$>\n"
+        "{\n"
+        "    enum\n"
+        "    {\n"
+        "        WithZeroConstructor = true,\n"
+        "        WithNoDestructor = true,\n"
+        "    };\n"
+        "};\n"
+        "\n"
+        "template<> struct TIsPODType<F$classname$> { enum { Value = true }; };\n"
+        , "classname", classname_);
+}
+
+void UEMessageGenerator::GenerateScalarOnlyArrays(io::Printer* printer)
+{
+    // Straight-line loops over the fields with no per-element call or
+    // construction, so the compiler can unroll and vectorize them.
+    printer->Print(
+        "void F$classname$::FromPBArray(const ::google::protobuf::RepeatedPtrField<$classname$>& Src, F$classname$* Out) {\n"
+        "    for (const $classname$& pbMessage : Src) {\n"
+        , "classname", classname_);
+    for (int i = 0; i < descriptor_->field_count(); i++)
+    {
+        const FieldDescriptor* field = descriptor_->field(i);
         printer->Print(
-            "float $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
-    case FieldDescriptor::CPPTYPE_DOUBLE:
+            field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM
+                ? "        Out->$field_name$ = static_cast<$enum_type$>(pbMessage.$lowercase_name$());\n"
+                : "        Out->$field_name$ = pbMessage.$lowercase_name$();\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name()
+            , "enum_type", field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM ? "E" + ClassName(field->enum_type(), false) : "");
+    }
+    printer->Print(
+        "        ++Out;\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "void F$classname$::ToPBArray(const F$classname$* Src, int32 Num, ::google::protobuf::RepeatedPtrField<$classname$>* Out) {\n"
+        "    Out->Reserve(Out->size() + Num);\n"
+        "    for (const F$classname$* End = Src + Num; Src != End; ++Src) {\n"
+        "        $classname$& pbMessage = *Out->Add();\n"
+        , "classname", classname_);
+    for (int i = 0; i < descriptor_->field_count(); i++)
+    {
+        const FieldDescriptor* field = descriptor_->field(i);
         printer->Print(
-            "double $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
+            field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM
+                ? "        pbMessage.set_$lowercase_name$(static_cast<$enum_type$>(Src->$field_name$));\n"
+                : "        pbMessage.set_$lowercase_name$(Src->$field_name$);\n"
+            , "field_name", FieldName(field)
+            , "lowercase_name", field->lowercase_name()
+            , "enum_type", field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM ? ClassName(field->enum_type(), true) : "");
+    }
+    printer->Print(
+        "    }\n"
+        "}\n"
+        "\n");
+}
+
+bool UEMessageGenerator::IsDeltaPush()
+{
+    return options_.delta_push && ends_with(classname_, "Push");
+}
+
+// "<name>_removed" lists the keys a delta push deletes from map or keyed
+// repeated field <name>; it must be a repeated field of the key's type.
+static const FieldDescriptor* DeltaRemovedField(const FieldDescriptor* field, const FieldDescriptor* key)
+{
+    const FieldDescriptor* removed = field->containing_type()->FindFieldByName(field->name() + "_removed");
+    if (removed == NULL || !removed->is_repeated() || removed->is_map() || removed->type() != key->type())
+    {
+        return NULL;
+    }
+    return removed;
+}
+
+// Sub-field named by the "key=" annotation of a repeated message field.
+static const FieldDescriptor* DeltaKeyField(const FieldDescriptor* field)
+{
+    string key_name;
+    if (!field->is_repeated() || field->is_map() || field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE
+        || !GetFieldAnnotation(field, "key", &key_name))
+    {
+        return NULL;
+    }
+    const FieldDescriptor* key = field->message_type()->FindFieldByName(key_name);
+    if (key == NULL || key->is_repeated() || key->containing_oneof() != NULL)
+    {
+        return NULL;
+    }
+    switch (key->cpp_type())
+    {
+    case FieldDescriptor::CPPTYPE_INT32:
+    case FieldDescriptor::CPPTYPE_INT64:
     case FieldDescriptor::CPPTYPE_UINT32:
-        printer->Print(
-            "uint32 $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
     case FieldDescriptor::CPPTYPE_UINT64:
+        return key;
+    case FieldDescriptor::CPPTYPE_STRING:
+        return key->type() == FieldDescriptor::TYPE_STRING ? key : NULL;
+    default:
+        return NULL;
+    }
+}
+
+static string DeltaKeyValue(const FieldDescriptor* key, const string& value, bool name)
+{
+    if (name)
+    {
+        return "ProtoUE::Utf8ToFName(" + value + ")";
+    }
+    return key->cpp_type() == FieldDescriptor::CPPTYPE_STRING ? "ProtoUE::ToFString(" + value + ")" : value;
+}
+
+static bool IsDeltaRemovedField(const FieldDescriptor* field)
+{
+    const string suffix = "_removed";
+    if (!ends_with(field->name(), suffix))
+    {
+        return false;
+    }
+    const FieldDescriptor* base = field->containing_type()->FindFieldByName(
+        field->name().substr(0, field->name().size() - suffix.size()));
+    if (base == NULL)
+    {
+        return false;
+    }
+    if (base->is_map())
+    {
+        return DeltaRemovedField(base, base->message_type()->FindFieldByName("key")) == field;
+    }
+    const FieldDescriptor* key = DeltaKeyField(base);
+    return key != NULL && DeltaRemovedField(base, key) == field;
+}
+
+void UEMessageGenerator::FromPBDelta_Keyed(io::Printer* printer, const FieldDescriptor* field, const FieldDescriptor* key)
+{
+    std::map<string, string> vars;
+    vars["field_name"] = FieldName(field);
+    vars["lowercase_name"] = field->lowercase_name();
+    vars["element_type"] = "F" + ClassName(field->message_type(), false);
+    vars["key_type"] = IsNameStringField(key) ? "FName" : PrimitiveTypeName(key->cpp_type());
+    // Protobuf string keys are case-sensitive, FString's default KeyFuncs are not.
+    const bool string_key = key->cpp_type() == FieldDescriptor::CPPTYPE_STRING && !IsNameStringField(key);
+    vars["set_type"] = string_key
+        ? "TSet<FString, ProtoUE::FCaseSensitiveStringKeyFuncs>" : "TSet<" + vars["key_type"] + ">";
+    vars["index_type"] = string_key
+        ? "TMap<FString, int32, FDefaultSetAllocator, ProtoUE::TCaseSensitiveStringMapKeyFuncs<int32>>"
+        : "TMap<" + vars["key_type"] + ", int32>";
+    vars["key_member"] = FieldName(key);
+    vars["element_key"] = DeltaKeyValue(key, "element." + key->lowercase_name() + "()", IsNameStringField(key));
+
+    const FieldDescriptor* removed = DeltaRemovedField(field, key);
+    if (removed != NULL)
+    {
+        vars["removed_name"] = removed->lowercase_name();
+        vars["removed_key"] = DeltaKeyValue(key, "Key", IsNameStringField(key));
+        printer->Print(vars,
+            "if (pbMessage.$removed_name$_size() > 0) {\n"
+            "    $set_type$ Removed;\n"
+            "    Removed.Reserve(pbMessage.$removed_name$_size());\n"
+            "    for (const auto& Key : pbMessage.$removed_name$()) {\n"
+            "        Removed.Add($removed_key$);\n"
+            "    }\n"
+            "    $field_name$.RemoveAll([&Removed](const $element_type$& Element) { return Removed.Contains(Element.$key_member$); });\n"
+            "}\n");
+    }
+
+    // Index the current elements once so each update is a hash lookup. An
+    // update replaces the stored element; FromPB alone would append to its
+    // arrays.
+    printer->Print(vars,
+        "if (pbMessage.$lowercase_name$_size() > 0) {\n"
+        "    $index_type$ Index;\n"
+        "    Index.Reserve($field_name$.Num());\n"
+        "    for (int32 Position = 0; Position < $field_name$.Num(); ++Position) {\n"
+        "        Index.Add($field_name$[Position].$key_member$, Position);\n"
+        "    }\n"
+        "    for (const auto& element : pbMessage.$lowercase_name$()) {\n"
+        "        const int32* Found = Index.Find($element_key$);\n"
+        "        if (Found != nullptr) {\n"
+        "            $field_name$[*Found] = $element_type$();\n"
+        "            $field_name$[*Found].FromPB(element);\n"
+        "        }\n"
+        "        else {\n"
+        "            Index.Add($element_key$, $field_name$.Num());\n"
+        "            $field_name$[$field_name$.AddDefaulted()].FromPB(element);\n"
+        "        }\n"
+        "    }\n"
+        "}\n\n");
+}
+
+void UEMessageGenerator::FromPBDelta(io::Printer* printer)
+{
+    // Entries are upserted and never cleared wholesale, so every field is
+    // converted without reuse_containers.
+    for (int i = 0; i < optimized_order_.size(); i++)
+    {
+        const FieldDescriptor* field = optimized_order_[i];
+        if (IsDeltaRemovedField(field))
+        {
+            continue;
+        }
+
+        if (field->is_map())
+        {
+            const FieldDescriptor* key = field->message_type()->FindFieldByName("key");
+            const FieldDescriptor* removed = DeltaRemovedField(field, key);
+            if (removed != NULL)
+            {
+                printer->Print(
+                    "for (const auto& Key : pbMessage.$removed_name$()) {\n"
+                    "    $field_name$.Remove($key$);\n"
+                    "}\n"
+                    , "removed_name", removed->lowercase_name()
+                    , "field_name", FieldName(field)
+                    , "key", DeltaKeyValue(key, "Key", HasNameKey(field)));
+            }
+            FromPBMessage_Map(printer, field, false);
+            continue;
+        }
+
+        if (field->is_repeated())
+        {
+            const FieldDescriptor* key = DeltaKeyField(field);
+            if (key != NULL)
+            {
+                FromPBDelta_Keyed(printer, field, key);
+                continue;
+            }
+            // Unkeyed arrays are replaced when the push carries them.
+            printer->Print(
+                "if (pbMessage.$lowercase_name$_size() > 0) {\n"
+                "    $field_name$.Reset();\n"
+                "}\n"
+                , "field_name", FieldName(field)
+                , "lowercase_name", field->lowercase_name());
+            FromPBMessage_Repeated(printer, field, false);
+            continue;
+        }
+
+        // A present sub-message replaces the stored struct as a whole. The
+        // delta rules only apply at the top level: the nested FromPB would
+        // append to the old arrays otherwise.
+        if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE)
+        {
+            printer->Print(
+                HasStructReset()
+                    ? "if (pbMessage.has_$lowercase_name$()) {\n"
+                      "    $field_name$.Reset();\n"
+                      "    $field_name$.FromPB(pbMessage.$lowercase_name$());\n"
+                      "}\n"
+                    : "if (pbMessage.has_$lowercase_name$()) {\n"
+                      "    $field_name$ = F$field_type$();\n"
+                      "    $field_name$.FromPB(pbMessage.$lowercase_name$());\n"
+                      "}\n"
+                , "field_name", FieldName(field)
+                , "field_type", ClassName(field->message_type(), false)
+                , "lowercase_name", field->lowercase_name());
+            continue;
+        }
+
+        // presence_aware already checks has_x() for proto2 fields without an
+        // explicit default.
+        string check;
+        if (HasFieldPresence(field->file()))
+        {
+            if (!options_.presence_aware || field->has_default_value())
+            {
+                check = "pbMessage.has_" + field->lowercase_name() + "()";
+            }
+        }
+        else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING)
+        {
+            // proto3 cannot tell "unchanged" from "default", a delta can only
+            // carry non-default values.
+            check = "!pbMessage." + field->lowercase_name() + "().empty()";
+        }
+        else
+        {
+            check = "pbMessage." + field->lowercase_name() + "() != 0";
+        }
+
+        if (!check.empty())
+        {
+            printer->Print("if ($check$) {\n", "check", check);
+            printer->Indent();
+        }
+        FromPBMessage_Normal(printer, field, false);
+        if (!check.empty())
+        {
+            printer->Outdent();
+            printer->Print("}\n");
+        }
+    }
+
+    // A oneof that is not set in the delta keeps its current member.
+    for (int i = 0; i < descriptor_->oneof_decl_count(); i++)
+    {
+        FromPBOneof(printer, descriptor_->oneof_decl(i), true);
+    }
+}
+
+void UEMessageGenerator::GeneratePBMessageDeclaration(io::Printer* printer)
+{
+    if (!options_.arena)
+    {
         printer->Print(
-            "uint64 $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
+            "$classname$ pbMessage;\n",
+            "classname", classname_);
+        return;
+    }
+
+    // Messages without cc_enable_arenas still live in the arena block, only
+    // their sub-objects come from the heap.
+    printer->Print(
+        "ProtoUE::FArenaScope Arena;\n"
+        "$classname$& pbMessage = *google::protobuf::Arena::$create$<$classname$>(Arena.Get());\n",
+        "classname", classname_,
+        "create", SupportsArenas(descriptor_) ? "CreateMessage" : "Create");
+}
+
+// Encoded size of a fixed width field type, 0 for varint and length
+// delimited types.
+static int FixedWireSize(const FieldDescriptor* field)
+{
+    switch (field->type())
+    {
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_FLOAT:
+        return 4;
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_DOUBLE:
+        return 8;
+    case FieldDescriptor::TYPE_BOOL:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// Expression for the encoded size of value without its tag. With cached set
+// nested structs report the size stored by the preceding size pass.
+static string WireValueSize(const FieldDescriptor* field, const string& value, const Options& options, bool cached)
+{
+    const int fixed = FixedWireSize(field);
+    if (fixed > 0)
+    {
+        return SimpleItoa(fixed);
+    }
+    switch (field->cpp_type())
+    {
+    case FieldDescriptor::CPPTYPE_STRING:
+        if (IsLazyStringField(field, options))
+        {
+            return "WireFormatLite::StringSize(" + value + ".GetUtf8())";
+        }
+        return "ProtoUE::StringWireSize(" + value + ")";
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+        return string(cached ? "ProtoUE::CachedMessageWireSize(" : "ProtoUE::MessageWireSize(") + value + ")";
+    default:
+        return string("WireFormatLite::") + DeclaredTypeMethodName(field->type()) + "Size(" + WireScalar(field, value) + ")";
+    }
+}
+
+static string WireWriteStatement(const FieldDescriptor* field, const string& number, const string& value, const Options& options)
+{
+    switch (field->cpp_type())
+    {
+    case FieldDescriptor::CPPTYPE_STRING:
+        if (IsLazyStringField(field, options))
+        {
+            return "Target = WireFormatLite::WriteStringToArray(" + number + ", " + value + ".GetUtf8(), Target);\n";
+        }
+        return "Target = ProtoUE::WriteStringToArray(" + number + ", " + value + ", Target);\n";
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+        return "Target = ProtoUE::WriteMessageToArray(" + number + ", " + value + ", Target);\n";
+    default:
+        return string("Target = WireFormatLite::Write") + DeclaredTypeMethodName(field->type()) + "ToArray(" + number + ", " + WireScalar(field, value) + ", Target);\n";
+    }
+}
+
+// Declares DataSize, the payload length of a packed repeated field.
+static void PrintPackedDataSize(io::Printer* printer, const FieldDescriptor* field, const Options& options)
+{
+    const int fixed = FixedWireSize(field);
+    if (fixed > 0)
+    {
+        printer->Print(
+            "const size_t DataSize = $fixed$ * static_cast<size_t>($field_name$.Num());\n"
+            , "fixed", SimpleItoa(fixed)
+            , "field_name", FieldName(field));
+        return;
+    }
+    printer->Print(
+        "size_t DataSize = 0;\n"
+        "for (const auto& Element : $field_name$)\n"
+        "{\n"
+        "    DataSize += $element_size$;\n"
+        "}\n"
+        , "field_name", FieldName(field)
+        , "element_size", WireValueSize(field, "Element", options, false));
+}
+
+// Declares EntrySize, the payload length of one map entry. Key and value
+// always carry a one byte tag and are always written, as MapEntry does.
+static void PrintMapEntrySize(io::Printer* printer, const FieldDescriptor* field, const Options& options, bool cached)
+{
+    const FieldDescriptor* key = field->message_type()->FindFieldByName("key");
+    const FieldDescriptor* value = field->message_type()->FindFieldByName("value");
+    printer->Print(
+        "const size_t EntrySize = 2 + $key_size$ + $value_size$;\n"
+        , "key_size", WireValueSize(key, "Element.Key", options, cached)
+        , "value_size", WireValueSize(value, "Element.Value", options, cached));
+}
+
+void UEMessageGenerator::WireSize_Field(io::Printer* printer, const FieldDescriptor* field)
+{
+    std::map<string, string> vars;
+    vars["field_name"] = FieldName(field);
+    vars["tag_size"] = SimpleItoa(internal::WireFormat::TagSize(field->number(), field->type()));
+
+    if (field->is_map())
+    {
+        printer->Print(vars,
+            "for (const auto& Element : $field_name$)\n"
+            "{\n");
+        printer->Indent();
+        PrintMapEntrySize(printer, field, options_, false);
+        printer->Print(vars,
+            "Total += $tag_size$ + CodedOutputStream::VarintSize32(static_cast<uint32>(EntrySize)) + EntrySize;\n");
+        printer->Outdent();
+        printer->Print("}\n");
+        return;
+    }
+
+    if (field->is_packed())
+    {
+        printer->Print("{\n");
+        printer->Indent();
+        PrintPackedDataSize(printer, field, options_);
+        printer->Print(vars,
+            "if (DataSize > 0)\n"
+            "{\n"
+            "    Total += $tag_size$ + CodedOutputStream::VarintSize32(static_cast<uint32>(DataSize)) + DataSize;\n"
+            "}\n");
+        printer->Outdent();
+        printer->Print("}\n");
+        return;
+    }
+
+    if (field->is_repeated())
+    {
+        const int fixed = FixedWireSize(field);
+        if (fixed > 0)
+        {
+            vars["element_size"] = SimpleItoa(fixed);
+            printer->Print(vars,
+                "Total += ($tag_size$ + $element_size$) * static_cast<size_t>($field_name$.Num());\n");
+            return;
+        }
+        vars["element_size"] = WireValueSize(field, "Element", options_, false);
+        printer->Print(vars,
+            "Total += $tag_size$ * static_cast<size_t>($field_name$.Num());\n"
+            "for (const auto& Element : $field_name$)\n"
+            "{\n"
+            "    Total += $element_size$;\n"
+            "}\n");
+        return;
+    }
+
+    vars["check"] = Proto3NonDefaultCheck(field);
+    vars["value_size"] = WireValueSize(field, FieldName(field), options_, false);
+    if (vars["check"].empty())
+    {
+        printer->Print(vars, "Total += $tag_size$ + $value_size$;\n");
+        return;
+    }
+    printer->Print(vars,
+        "if ($check$)\n"
+        "{\n"
+        "    Total += $tag_size$ + $value_size$;\n"
+        "}\n");
+}
+
+void UEMessageGenerator::WireWrite_Field(io::Printer* printer, const FieldDescriptor* field)
+{
+    std::map<string, string> vars;
+    vars["field_name"] = FieldName(field);
+    vars["number"] = SimpleItoa(field->number());
+
+    if (field->is_map())
+    {
+        const FieldDescriptor* key = field->message_type()->FindFieldByName("key");
+        const FieldDescriptor* value = field->message_type()->FindFieldByName("value");
+        printer->Print(vars,
+            "for (const auto& Element : $field_name$)\n"
+            "{\n");
+        printer->Indent();
+        PrintMapEntrySize(printer, field, options_, true);
+        printer->Print(vars,
+            "Target = WireFormatLite::WriteTagToArray($number$, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);\n"
+            "Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(EntrySize), Target);\n");
+        printer->Print(WireWriteStatement(key, "1", "Element.Key", options_).c_str());
+        printer->Print(WireWriteStatement(value, "2", "Element.Value", options_).c_str());
+        printer->Outdent();
+        printer->Print("}\n");
+        return;
+    }
+
+    if (field->is_packed())
+    {
+        vars["write"] = string("WireFormatLite::Write") + DeclaredTypeMethodName(field->type()) + "NoTagToArray";
+        vars["element"] = WireScalar(field, "Element");
+        printer->Print(vars,
+            "if ($field_name$.Num() > 0)\n"
+            "{\n");
+        printer->Indent();
+        PrintPackedDataSize(printer, field, options_);
+        printer->Print(vars,
+            "Target = WireFormatLite::WriteTagToArray($number$, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, Target);\n"
+            "Target = CodedOutputStream::WriteVarint32ToArray(static_cast<uint32>(DataSize), Target);\n"
+            "for (const auto& Element : $field_name$)\n"
+            "{\n"
+            "    Target = $write$($element$, Target);\n"
+            "}\n");
+        printer->Outdent();
+        printer->Print("}\n");
+        return;
+    }
+
+    if (field->is_repeated())
+    {
+        printer->Print(vars,
+            "for (const auto& Element : $field_name$)\n"
+            "{\n");
+        printer->Indent();
+        printer->Print(WireWriteStatement(field, vars["number"], "Element", options_).c_str());
+        printer->Outdent();
+        printer->Print("}\n");
+        return;
+    }
+
+    const string check = Proto3NonDefaultCheck(field);
+    const string write = WireWriteStatement(field, vars["number"], FieldName(field), options_);
+    if (check.empty())
+    {
+        printer->Print(write.c_str());
+        return;
+    }
+    printer->Print(
+        "if ($check$)\n"
+        "{\n"
+        , "check", check);
+    printer->Indent();
+    printer->Print(write.c_str());
+    printer->Outdent();
+    printer->Print("}\n");
+}
+
+static bool FieldNumberLess(const FieldDescriptor* a, const FieldDescriptor* b)
+{
+    return a->number() < b->number();
+}
+
+// Fields sorted by number, the order the .pb.cc serializer writes them in.
+static std::vector<const FieldDescriptor*> FieldsInWireOrder(const std::vector<const FieldDescriptor*>& fields)
+{
+    std::vector<const FieldDescriptor*> sorted(fields);
+    std::sort(sorted.begin(), sorted.end(), FieldNumberLess);
+    return sorted;
+}
+
+void UEMessageGenerator::GenerateWireSize(io::Printer* printer, const string& qualified_classname)
+{
+    if (options_.table_driven_serialization && HasWireTable())
+    {
+        printer->Print(
+            "int32 $qualified_classname$::ComputeWireSize() const\n"
+            "{\n"
+            "    return static_cast<int32>(ProtoUE::ComputeWireSize(this, WireTable()));\n"
+            "}\n"
+            "\n"
+            , "qualified_classname", qualified_classname);
+        return;
+    }
+    printer->Print(
+        "int32 $qualified_classname$::ComputeWireSize() const\n"
+        "{\n"
+        , "qualified_classname", qualified_classname);
+    printer->Indent();
+    printer->Print(
+        "using ProtoUE::WireFormatLite;\n"
+        "using ProtoUE::CodedOutputStream;\n"
+        "size_t Total = 0;\n");
+    const std::vector<const FieldDescriptor*> fields = FieldsInWireOrder(optimized_order_);
+    for (int i = 0; i < fields.size(); ++i)
+    {
+        const string dirty = DirtyBitCheck(fields[i]);
+        if (!dirty.empty())
+        {
+            printer->Print("if ($dirty$)\n{\n", "dirty", dirty);
+            printer->Indent();
+        }
+        WireSize_Field(printer, fields[i]);
+        if (!dirty.empty())
+        {
+            printer->Outdent();
+            printer->Print("}\n");
+        }
+    }
+    if (ends_with(classname_, "Req"))
+    {
+        printer->Print("return static_cast<int32>(Total);\n");
+    }
+    else
+    {
+        printer->Print(
+            "CachedWireSize = static_cast<int32>(Total);\n"
+            "return CachedWireSize;\n");
+    }
+    printer->Outdent();
+    printer->Print("}\n\n");
+}
+
+void UEMessageGenerator::GenerateWireSerializer(io::Printer* printer, const string& qualified_classname)
+{
+    if (options_.table_driven_serialization && HasWireTable())
+    {
+        printer->Print(
+            "uint8* $qualified_classname$::SerializeWire(uint8* Target) const\n"
+            "{\n"
+            "    return ProtoUE::SerializeWire(this, WireTable(), Target);\n"
+            "}\n"
+            "\n"
+            , "qualified_classname", qualified_classname);
+        return;
+    }
+    printer->Print(
+        "uint8* $qualified_classname$::SerializeWire(uint8* Target) const\n"
+        "{\n"
+        , "qualified_classname", qualified_classname);
+    printer->Indent();
+    printer->Print(
+        "using ProtoUE::WireFormatLite;\n"
+        "using ProtoUE::CodedOutputStream;\n");
+    const std::vector<const FieldDescriptor*> fields = FieldsInWireOrder(optimized_order_);
+    for (int i = 0; i < fields.size(); ++i)
+    {
+        const string dirty = DirtyBitCheck(fields[i]);
+        if (!dirty.empty())
+        {
+            printer->Print("if ($dirty$)\n{\n", "dirty", dirty);
+            printer->Indent();
+        }
+        WireWrite_Field(printer, fields[i]);
+        if (!dirty.empty())
+        {
+            printer->Outdent();
+            printer->Print("}\n");
+        }
+    }
+    printer->Print("return Target;\n");
+    printer->Outdent();
+    printer->Print("}\n\n");
+}
+
+// protobuf C++ type ReadPrimitive is instantiated with for field.
+static string WireCppType(const FieldDescriptor* field)
+{
+    switch (field->cpp_type())
+    {
+    case FieldDescriptor::CPPTYPE_INT32:
+        return "::google::protobuf::int32";
+    case FieldDescriptor::CPPTYPE_INT64:
+        return "::google::protobuf::int64";
+    case FieldDescriptor::CPPTYPE_UINT32:
+        return "::google::protobuf::uint32";
+    case FieldDescriptor::CPPTYPE_UINT64:
+        return "::google::protobuf::uint64";
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+        return "double";
+    case FieldDescriptor::CPPTYPE_FLOAT:
+        return "float";
     case FieldDescriptor::CPPTYPE_BOOL:
+        return "bool";
+    case FieldDescriptor::CPPTYPE_ENUM:
+        return "int";
+    default:
+        return "";
+    }
+}
+
+static string WireFieldType(const FieldDescriptor* field)
+{
+    return "WireFormatLite::TYPE_" + ToUpper(DeclaredTypeMethodName(field->type()));
+}
+
+// bool expression reading one value of field into target.
+static string WireReadExpression(const FieldDescriptor* field, const string& target)
+{
+    switch (field->cpp_type())
+    {
+    case FieldDescriptor::CPPTYPE_STRING:
+        return "ProtoUE::ReadString(Input, " + target + ")";
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+        return "ProtoUE::ReadMessage(Input, " + target + ")";
+    default:
+        return "ProtoUE::ReadScalar< " + WireCppType(field) + ", " + WireFieldType(field) + ">(Input, " + target + ")";
+    }
+}
+
+static string WireTag(const FieldDescriptor* field, internal::WireFormatLite::WireType type)
+{
+    return SimpleItoa(internal::WireFormatLite::MakeTag(field->number(), type)) + "u";
+}
+
+static void PrintWireRead(io::Printer* printer, const string& tag, const string& read)
+{
+    printer->Print(
+        "if (Tag == $tag$)\n"
+        "{\n"
+        "    if (!$read$)\n"
+        "    {\n"
+        "        return false;\n"
+        "    }\n"
+        "    continue;\n"
+        "}\n"
+        , "tag", tag
+        , "read", read);
+}
+
+void UEMessageGenerator::WireRead_Field(io::Printer* printer, const FieldDescriptor* field)
+{
+    const string field_name = FieldName(field);
+    const internal::WireFormatLite::WireType wire_type = internal::WireFormat::WireTypeForFieldType(field->type());
+
+    printer->Print("case $number$:\n", "number", SimpleItoa(field->number()));
+    printer->Indent();
+
+    if (field->is_map())
+    {
+        const FieldDescriptor* key = field->message_type()->FindFieldByName("key");
+        const FieldDescriptor* value = field->message_type()->FindFieldByName("value");
+        std::map<string, string> vars;
+        vars["tag"] = WireTag(field, internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+        vars["field_name"] = field_name;
+        vars["key_tag"] = WireTag(key, internal::WireFormat::WireTypeForFieldType(key->type()));
+        vars["value_tag"] = WireTag(value, internal::WireFormat::WireTypeForFieldType(value->type()));
+        vars["read_key"] = WireReadExpression(key, "Entry.Key");
+        vars["read_value"] = WireReadExpression(value, "Entry.Value");
+        // Missing keys/values stay default, a repeated key replaces the
+        // earlier entry, as with protobuf's Map.
+        printer->Print(vars,
+            "if (Tag == $tag$)\n"
+            "{\n"
+            "    decltype($field_name$)::ElementType Entry;\n"
+            "    int Length;\n"
+            "    if (!Input->ReadVarintSizeAsInt(&Length))\n"
+            "    {\n"
+            "        return false;\n"
+            "    }\n"
+            "    const std::pair<ProtoUE::CodedInputStream::Limit, int> Limit = Input->IncrementRecursionDepthAndPushLimit(Length);\n"
+            "    if (Limit.second < 0)\n"
+            "    {\n"
+            "        return false;\n"
+            "    }\n"
+            "    for (uint32 EntryTag = Input->ReadTag(); EntryTag != 0; EntryTag = Input->ReadTag())\n"
+            "    {\n"
+            "        const bool bRead = EntryTag == $key_tag$ ? $read_key$\n"
+            "            : EntryTag == $value_tag$ ? $read_value$\n"
+            "            : WireFormatLite::SkipField(Input, EntryTag);\n"
+            "        if (!bRead)\n"
+            "        {\n"
+            "            return false;\n"
+            "        }\n"
+            "    }\n"
+            "    if (!Input->DecrementRecursionDepthAndPopLimit(Limit.first))\n"
+            "    {\n"
+            "        return false;\n"
+            "    }\n"
+            "    $field_name$.Add(MoveTemp(Entry.Key), MoveTemp(Entry.Value));\n"
+            "    continue;\n"
+            "}\n");
+    }
+    else if (field->is_repeated())
+    {
+        const string element = field_name + "[" + field_name + ".AddDefaulted()]";
+        PrintWireRead(printer, WireTag(field, wire_type), WireReadExpression(field, element));
+        // Parsers must accept both encodings of a packable field.
+        if (internal::WireFormat::WireTypeForFieldType(field->type()) != internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+        {
+            const bool bulk = FixedWireSize(field) > 0 && field->cpp_type() != FieldDescriptor::CPPTYPE_BOOL;
+            PrintWireRead(printer,
+                WireTag(field, internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED),
+                string(bulk ? "ProtoUE::ReadPackedFixed< " : "ProtoUE::ReadPackedScalars< ")
+                    + WireCppType(field) + ", " + WireFieldType(field) + ">(Input, " + field_name + ")");
+        }
+    }
+    else
+    {
+        PrintWireRead(printer, WireTag(field, wire_type), WireReadExpression(field, field_name));
+    }
+
+    printer->Print("break;\n");
+    printer->Outdent();
+}
+
+void UEMessageGenerator::GenerateWireParser(io::Printer* printer, const string& qualified_classname)
+{
+    if (options_.table_driven_parsing && HasWireTable())
+    {
         printer->Print(
-            "bool $field_name$ = element.$field_part$;\n"
-            , "field_name", FieldName(field),
-            "field_part", part);
-        break;
+            "bool $qualified_classname$::MergeFromWire(::google::protobuf::io::CodedInputStream* Input)\n"
+            "{\n"
+            "    return ProtoUE::MergeFromWire(Input, this, WireTable());\n"
+            "}\n"
+            "\n"
+            , "qualified_classname", qualified_classname);
+        return;
+    }
+    printer->Print(
+        "bool $qualified_classname$::MergeFromWire(::google::protobuf::io::CodedInputStream* Input)\n"
+        "{\n"
+        "    using ProtoUE::WireFormatLite;\n"
+        "    for (;;)\n"
+        "    {\n"
+        "        const uint32 Tag = Input->ReadTag();\n"
+        "        if (Tag == 0)\n"
+        "        {\n"
+        "            return true;\n"
+        "        }\n"
+        "        switch (WireFormatLite::GetTagFieldNumber(Tag))\n"
+        "        {\n"
+        , "qualified_classname", qualified_classname);
+    printer->Indent();
+    printer->Indent();
+    const std::vector<const FieldDescriptor*> fields = FieldsInWireOrder(optimized_order_);
+    for (int i = 0; i < fields.size(); ++i)
+    {
+        WireRead_Field(printer, fields[i]);
+    }
+    printer->Outdent();
+    printer->Outdent();
+    // Unknown fields and known fields with an unexpected wire type are
+    // skipped, like the .pb.cc parser does without unknown field storage.
+    printer->Print(
+        "        default:\n"
+        "            break;\n"
+        "        }\n"
+        "        if (!WireFormatLite::SkipField(Input, Tag))\n"
+        "        {\n"
+        "            return false;\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+        "\n");
+}
+
+// Messages with a oneof anywhere below them keep the protobuf path, see
+// ContainsOneof().
+bool UEMessageGenerator::UsesWireParser()
+{
+    return (options_.direct_parsing || options_.table_driven_parsing) && !ContainsOneof(descriptor_);
+}
+
+bool UEMessageGenerator::UsesWireSerializer()
+{
+    return (options_.direct_serialization || options_.table_driven_serialization) && !ContainsOneof(descriptor_);
+}
+
+// The table reaches repeated members through the FScriptArray layout of the
+// default allocator, so messages with an inline capacity anywhere below them
+// keep the unrolled wire code (a nested table would be missing otherwise).
+static bool HasInlineCapacity(const Descriptor* descriptor, std::set<const Descriptor*>* visited)
+{
+    if (!visited->insert(descriptor).second)
+    {
+        return false;
+    }
+    for (int i = 0; i < descriptor->field_count(); i++)
+    {
+        const FieldDescriptor* field = descriptor->field(i);
+        if (InlineCapacity(field) > 0)
+        {
+            return true;
+        }
+        if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+            HasInlineCapacity(field->message_type(), visited))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UEMessageGenerator::HasWireTable()
+{
+    std::set<const Descriptor*> visited;
+    if (HasInlineCapacity(descriptor_, &visited) || ContainsOneof(descriptor_))
+    {
+        return false;
+    }
+    if (ends_with(classname_, "Req"))
+    {
+        return options_.table_driven_serialization;
+    }
+    if (ends_with(classname_, "Resp") || ends_with(classname_, "Push"))
+    {
+        return options_.table_driven_parsing && !IsDeltaPush();
+    }
+    return options_.table_driven_parsing || options_.table_driven_serialization;
+}
+
+// ProtoUE::EFieldKind of one value of field, "" for fields the table can not
+// describe. Map values hold the protobuf enum, which is int sized.
+static string TableFieldKind(const FieldDescriptor* field, const Options& options, bool map_value)
+{
+    switch (field->type())
+    {
+    case FieldDescriptor::TYPE_ENUM:
+        return map_value ? "Int32" : "Enum";
+    case FieldDescriptor::TYPE_STRING:
+        if (IsNameStringField(field))
+        {
+            return "Name";
+        }
+        return IsLazyStringField(field, options) ? "LazyString" : "String";
+    case FieldDescriptor::TYPE_BYTES:
+        return "Bytes";
+    case FieldDescriptor::TYPE_MESSAGE:
+        return "Message";
+    case FieldDescriptor::TYPE_GROUP:
+        return "";
     default:
-        break;
+        return DeclaredTypeMethodName(field->type());
     }
 }
 
-void UEMessageGenerator::FromPBMessage(io::Printer* printer)
+static string TableNested(const FieldDescriptor* field)
 {
-    for (int i = 0; i < descriptor_->field_count(); i++)
+    return field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE
+        ? "&F" + FieldMessageTypeName(field) + "::WireTable" : "nullptr";
+}
+
+void UEMessageGenerator::GenerateWireTable(io::Printer* printer, const string& qualified_classname)
+{
+    std::map<string, string> vars;
+    vars["qualified_classname"] = qualified_classname;
+    printer->Print(vars,
+        "const ProtoUE::FMessageTable& $qualified_classname$::WireTable()\n"
+        "{\n");
+    printer->Indent();
+
+    int num_fields = 0;
+    const std::vector<const FieldDescriptor*> fields = FieldsInWireOrder(optimized_order_);
+    for (int i = 0; i < fields.size(); ++i)
     {
-        const FieldDescriptor* field = descriptor_->field(i);
+        const FieldDescriptor* field = fields[i];
+        if (UEFieldType(field, options_).empty())
+        {
+            continue;
+        }
+
+        std::map<string, string> entry;
+        entry["number"] = SimpleItoa(field->number());
+        entry["qualified_classname"] = qualified_classname;
+        entry["field_name"] = FieldName(field);
+        entry["nested"] = "nullptr";
+        entry["custom"] = "nullptr";
         if (field->is_map())
         {
-            FromPBMessage_Map(printer, field);
+            const FieldDescriptor* key = field->message_type()->FindFieldByName("key");
+            const FieldDescriptor* val = field->message_type()->FindFieldByName("value");
+            if (TableFieldKind(key, options_, false).empty() || TableFieldKind(val, options_, true).empty())
+            {
+                continue;
+            }
+            entry["kind"] = "Custom";
+            entry["custom"] = "&ProtoUE::TMapFieldCodec<" + UEFieldType(field, options_) +
+                ", ProtoUE::EFieldKind::" + (HasNameKey(field) ? "Name" : TableFieldKind(key, options_, false)) +
+                ", ProtoUE::EFieldKind::" + TableFieldKind(val, options_, true) +
+                (val->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ? ", " + TableNested(val) : "") +
+                ">::Codec";
+        }
+        else
+        {
+            entry["kind"] = TableFieldKind(field, options_, false);
+            if (entry["kind"].empty())
+            {
+                continue;
+            }
+            entry["nested"] = TableNested(field);
         }
-        else if (field->is_repeated())
+
+        string flags;
+        if (field->is_repeated() && !field->is_map())
+        {
+            flags = "ProtoUE::EFieldFlags::Repeated";
+            if (field->is_packed())
+            {
+                flags += " | ProtoUE::EFieldFlags::Packed";
+            }
+        }
+        else if (!Proto3NonDefaultCheck(field).empty())
+        {
+            flags = "ProtoUE::EFieldFlags::SkipDefault";
+        }
+        entry["flags"] = flags.empty() ? "ProtoUE::EFieldFlags::None" : flags;
+
+        const int bit = std::find(optimized_order_.begin(), optimized_order_.end(), field) - optimized_order_.begin();
+        entry["dirty_bit"] = IsDirtyTrackedField(field, options_) ? SimpleItoa(bit) : "-1";
+
+        if (num_fields++ == 0)
+        {
+            printer->Print("static const ProtoUE::FFieldEntry Fields[] =\n{\n");
+            printer->Indent();
+        }
+        printer->Print(entry,
+            "{ $number$, STRUCT_OFFSET($qualified_classname$, $field_name$), ProtoUE::EFieldKind::$kind$, $flags$, $dirty_bit$, $nested$, $custom$ },\n");
+    }
+    if (num_fields > 0)
+    {
+        printer->Outdent();
+        printer->Print("};\n");
+    }
+
+    // UObjects are never nested, only plain structs are constructed by the
+    // interpreter or carry a cached size.
+    const bool is_struct = !ends_with(classname_, "Req") && !ends_with(classname_, "Resp") && !ends_with(classname_, "Push");
+    vars["fields"] = num_fields > 0 ? "Fields" : "nullptr";
+    vars["num_fields"] = SimpleItoa(num_fields);
+    vars["cached_size"] = is_struct && UsesWireSerializer()
+        ? "STRUCT_OFFSET(" + qualified_classname + ", CachedWireSize)" : "-1";
+    vars["dirty_bits"] = options_.dirty_tracking && ends_with(classname_, "Req")
+        ? "STRUCT_OFFSET(" + qualified_classname + ", DirtyBits)" : "-1";
+    vars["construct"] = is_struct ? "&ProtoUE::ConstructStruct<" + qualified_classname + ">" : "nullptr";
+    vars["destruct"] = is_struct ? "&ProtoUE::DestructStruct<" + qualified_classname + ">" : "nullptr";
+    printer->Print(vars,
+        "static const ProtoUE::FMessageTable Table =\n"
+        "{\n"
+        "    $fields$, $num_fields$, sizeof($qualified_classname$), $cached_size$, $dirty_bits$, $construct$, $destruct$\n"
+        "};\n"
+        "return Table;\n");
+    printer->Outdent();
+    printer->Print("}\n\n");
+}
+
+void UEMessageGenerator::GeneratePoolDeclarations(io::Printer* printer)
+{
+    printer->Print(
+        "\n"
+        "// Pooled instance, see ProtoUEPool.h. Release() it once it is no longer used.\n"
+        "static U$classname$* Acquire();\n"
+        "void Release();\n"
+        "// Restores the freshly constructed state, keeping container capacity.\n"
+        "void Reset();\n"
+        , "classname", classname_);
+}
+
+void UEMessageGenerator::GeneratePoolMethods(io::Printer* printer)
+{
+    printer->Print(
+        "U$classname$* U$classname$::Acquire()\n"
+        "{\n"
+        "    return ProtoUE::TObjectPool<U$classname$>::Get().Acquire();\n"
+        "}\n"
+        "\n"
+        "void U$classname$::Release()\n"
+        "{\n"
+        "    ProtoUE::TObjectPool<U$classname$>::Get().Release(this);\n"
+        "}\n"
+        "\n"
+        , "classname", classname_);
+}
+
+void UEMessageGenerator::GenerateReset(io::Printer* printer, const string& qualified_classname)
+{
+    printer->Print(
+        "void $qualified_classname$::Reset()\n"
+        "{\n"
+        , "qualified_classname", qualified_classname);
+    printer->Indent();
+    for (int i = 0; i < optimized_order_.size(); ++i)
+    {
+        const FieldDescriptor* field = optimized_order_[i];
+        if (UEFieldType(field, options_).empty())
+        {
+            continue;
+        }
+        std::map<string, string> vars;
+        vars["field_name"] = FieldName(field);
+        if (field->is_repeated() || field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ||
+            (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING && !IsNameStringField(field) &&
+             !IsBytesViewField(field, options_)))
         {
-            FromPBMessage_Repeated(printer, field);
+            printer->Print(vars, "$field_name$.Reset();\n");
         }
         else
         {
-            FromPBMessage_Normal(printer, field);
+            vars["default"] = UEDefaultValue(field);
+            printer->Print(vars, "$field_name$ = $default$;\n");
         }
     }
+    for (int i = 0; i < descriptor_->oneof_decl_count(); i++)
+    {
+        printer->Print("$member$.Reset();\n", "member", OneofMemberName(descriptor_->oneof_decl(i)));
+    }
+    if (options_.dirty_tracking && ends_with(classname_, "Req"))
+    {
+        printer->Print("MarkAllDirty();\n");
+    }
+    printer->Outdent();
+    printer->Print("}\n\n");
+}
+
+bool UEMessageGenerator::HasStructReset()
+{
+    return options_.object_pool || options_.reuse_containers;
+}
+
+// Reset() keeps the container capacity; without it the struct is replaced.
+string UEMessageGenerator::PayloadResetStatement(const string& target)
+{
+    if (HasStructReset())
+    {
+        return target + ".Reset();\n";
+    }
+    return target + " = F" + classname_ + "Struct();\n";
+}
+
+void UEMessageGenerator::GenerateSharedData(io::Printer* printer)
+{
+    // The first caller after Unpack() copies Data into the shared payload
+    // once. Data itself stays intact for every other reader, whatever order
+    // the listeners run in.
+    printer->Print(
+        "TSharedRef<const F$classname$Struct, ESPMode::ThreadSafe> U$classname$::GetSharedData()\n"
+        "{\n"
+        "    if (!SharedData.IsValid())\n"
+        "    {\n"
+        "        SharedData = MakeShared<F$classname$Struct, ESPMode::ThreadSafe>(Data);\n"
+        "    }\n"
+        "    return SharedData.ToSharedRef();\n"
+        "}\n"
+        "\n"
+        , "classname", classname_);
+}
+
+void UEMessageGenerator::GenerateAppendPayload(io::Printer* printer)
+{
+    printer->Print(
+        "void U$classname$::AppendPayload(TArray<uint8>& Out) {\n",
+        "classname", classname_);
+    printer->Indent();
+    if (UsesWireSerializer())
+    {
+        printer->Print(
+            "const int32 Size = ComputeWireSize();\n"
+            "const int32 Offset = Out.AddUninitialized(Size);\n"
+            "SerializeWire(Out.GetData() + Offset);\n");
+    }
+    else
+    {
+        GeneratePBMessageDeclaration(printer);
+        ToPBMessage(printer);
+        printer->Print(
+            "const int32 Size = static_cast<int32>(pbMessage.ByteSizeLong());\n"
+            "const int32 Offset = Out.AddUninitialized(Size);\n"
+            "pbMessage.SerializeWithCachedSizesToArray(Out.GetData() + Offset);\n");
+    }
+    const int compress_threshold = CompressionThreshold(descriptor_, options_);
+    if (compress_threshold > 0)
+    {
+        // Same frame as Pack(); the compressed bytes are never longer, so
+        // they overwrite the plain ones in place.
+        printer->Print(
+            "const uint8* Data = Out.GetData() + Offset;\n"
+            "int32 Compressed = Size;\n"
+            "ProtoUE::CompressPayload(Data, Compressed, $threshold$);\n"
+            "if (Compressed != Size)\n"
+            "{\n"
+            "    FMemory::Memcpy(Out.GetData() + Offset, Data, Compressed);\n"
+            "    Out.SetNum(Offset + Compressed, false);\n"
+            "}\n"
+            , "threshold", SimpleItoa(compress_threshold));
+    }
+    printer->Outdent();
+    printer->Print("}\n\n");
+}
+
+// Hands the serialized "Buffer" of Pack() to URequest::PackBytes(),
+// compressed when it reaches threshold.
+void UEMessageGenerator::GeneratePackBytes(io::Printer* printer, int threshold)
+{
+    if (threshold <= 0)
+    {
+        printer->Print("    URequest::PackBytes(Buffer.GetData(), Buffer.Num());\n");
+        return;
+    }
+    printer->Print(
+        "    const uint8* Data = Buffer.GetData();\n"
+        "    int32 Size = Buffer.Num();\n"
+        "    ProtoUE::CompressPayload(Data, Size, $threshold$);\n"
+        "    URequest::PackBytes(Data, Size);\n"
+        , "threshold", SimpleItoa(threshold));
+}
+
+void UEMessageGenerator::GenerateTwoPhaseUnpack(io::Printer* printer)
+{
+    printer->Print(
+        "bool U$classname$::ParseData(const uint8* Bytes, int32 Size, F$classname$Struct& Out) {\n",
+        "classname", classname_);
+    printer->Indent();
+    // Like Unpack(), Out starts empty and is left empty when the payload does
+    // not parse.
+    const string out_reset = PayloadResetStatement("Out");
+    printer->Print(out_reset.c_str());
+    if (CompressionThreshold(descriptor_, options_) > 0)
+    {
+        printer->Print(
+            "if (!ProtoUE::DecompressPayload(Bytes, Size))\n"
+            "{\n"
+            "    return false;\n"
+            "}\n");
+    }
+    if (UsesWireParser())
+    {
+        printer->Print(
+            "::google::protobuf::io::CodedInputStream Input(Bytes, Size);\n"
+            "if (!Out.MergeFromWire(&Input))\n"
+            "{\n"
+            "    $out_reset$"
+            "    return false;\n"
+            "}\n"
+            "return true;\n"
+            , "out_reset", out_reset);
+    }
+    else
+    {
+        GeneratePBMessageDeclaration(printer);
+        printer->Print(
+            "if (!pbMessage.ParseFromArray(Bytes, Size))\n"
+            "{\n"
+            "    return false;\n"
+            "}\n"
+            "Out.UnPack(pbMessage);\n"
+            "return true;\n");
+    }
+    printer->Outdent();
+    printer->Print(
+        "}\n"
+        "\n"
+        "void U$classname$::PublishData(F$classname$Struct&& Parsed) {\n"
+        "    check(IsInGameThread());\n",
+        "classname", classname_);
+    if (options_.shared_payload)
+    {
+        printer->Print("    SharedData.Reset();\n");
+    }
+    printer->Print(
+        "    Data = MoveTemp(Parsed);\n"
+        "    OnDataPublished.Broadcast();\n"
+        "}\n"
+        "\n");
 }
 
 void UEMessageGenerator::Flatten(std::vector<UEMessageGenerator*>* list)
@@ -619,21 +2600,77 @@ void UEMessageGenerator::GenerateClassMethods(io::Printer* printer)
         {
             className.replace(0, fileName.length(), "");
         }
-        printer->Print(
-            "void U$classname$::Pack() {\n"
-            "    $classname$ pbMessage;\n",
-            "classname", classname_
-        );
-        printer->Indent();
-        ToPBMessage(printer);
-        printer->Outdent();
-        printer->Print(
-            "    mMessage = &pbMessage;\n"
-            "    URequest::Pack();\n"
-            "}\n"
-            "\n",
-            "classname", classname_);
+        const int compress_threshold = CompressionThreshold(descriptor_, options_);
+        if (UsesWireSerializer())
+        {
+            // No intermediate protobuf message: the members are written
+            // straight into a per-thread buffer that keeps its capacity.
+            printer->Print(
+                "void U$classname$::Pack() {\n"
+                "    static thread_local TArray<uint8> Buffer;\n"
+                "    Buffer.SetNumUninitialized(ComputeWireSize(), false);\n"
+                "    SerializeWire(Buffer.GetData());\n",
+                "classname", classname_);
+            GeneratePackBytes(printer, compress_threshold);
+            printer->Print(
+                "}\n"
+                "\n");
+            GenerateWireSize(printer, "U" + classname_);
+            GenerateWireSerializer(printer, "U" + classname_);
+            if (HasWireTable())
+            {
+                GenerateWireTable(printer, "U" + classname_);
+            }
+        }
+        else
+        {
+            printer->Print(
+                "void U$classname$::Pack() {\n",
+                "classname", classname_
+            );
+            printer->Indent();
+            GeneratePBMessageDeclaration(printer);
+            ToPBMessage(printer);
+            printer->Outdent();
+            if (compress_threshold > 0)
+            {
+                // Compression needs the bytes, so serialize here instead of
+                // letting URequest::Pack() do it.
+                printer->Print(
+                    "    static thread_local TArray<uint8> Buffer;\n"
+                    "    Buffer.SetNumUninitialized(static_cast<int32>(pbMessage.ByteSizeLong()), false);\n"
+                    "    pbMessage.SerializeWithCachedSizesToArray(Buffer.GetData());\n");
+                GeneratePackBytes(printer, compress_threshold);
+                printer->Print(
+                    "}\n"
+                    "\n");
+            }
+            else
+            {
+                printer->Print(
+                    "    mMessage = &pbMessage;\n"
+                    "    URequest::Pack();\n"
+                    "}\n"
+                    "\n",
+                    "classname", classname_);
+            }
+        }
+
 
+        if (options_.batch_requests)
+        {
+            GenerateAppendPayload(printer);
+        }
+
+        if (options_.dirty_tracking)
+        {
+            GenerateDirtyTrackingMethods(printer);
+        }
+        if (options_.object_pool)
+        {
+            GenerateReset(printer, "U" + classname_);
+            GeneratePoolMethods(printer);
+        }
 
         printer->Print(
             "CMD U$classname$::GetCmd()\n"
@@ -651,40 +2688,148 @@ void UEMessageGenerator::GenerateClassMethods(io::Printer* printer)
             "void F$classname$Struct::UnPack($classname$& pbMessage) {\n",
             "classname", classname_);
         printer->Indent();
-        FromPBMessage(printer);
+        if (IsDeltaPush())
+        {
+            FromPBDelta(printer);
+        }
+        else if (HasWireTable())
+        {
+            // A payload the table cannot decode leaves the struct empty.
+            printer->Print(
+                "*this = F$classname$Struct();\n"
+                "if (!ProtoUE::MergeFromMessage(pbMessage, *this))\n"
+                "{\n"
+                "    *this = F$classname$Struct();\n"
+                "}\n",
+                "classname", classname_);
+        }
+        else
+        {
+            FromPBMessage(printer);
+        }
         printer->Outdent();
         printer->Print(
             "}\n"
             "\n",
             "classname", classname_);
 
+        // The std::string overload only forwards, the transport can hand its
+        // receive buffer to the pointer overload without copying it.
         printer->Print(
-            "void U$classname$::Unpack(const std::string& data) {\n", "classname", classname_);
-        printer->Indent();
-        printer->Print(
-            "$classname$ pbMessage;\n"
-            "pbMessage.ParseFromString(data);\n\n"
-            "Data.UnPack(pbMessage);\n",
-            "classname", classname_);
-        printer->Outdent();
-        printer->Print(
+            "void U$classname$::Unpack(const std::string& data) {\n"
+            "    Unpack(reinterpret_cast<const uint8*>(data.data()), static_cast<int32>(data.size()));\n"
             "}\n"
             "\n",
             "classname", classname_);
 
+        // shared_payload: a new message must not touch the payload earlier
+        // listeners still hold.
+        const char* shared_reset = options_.shared_payload ? "    SharedData.Reset();\n" : "";
+        // The peer decides whether to compress, a plain payload passes through.
+        const char* decompress = CompressionThreshold(descriptor_, options_) > 0
+            ? "    if (!ProtoUE::DecompressPayload(Bytes, Size))\n"
+              "    {\n"
+              "        return;\n"
+              "    }\n"
+            : "";
+
+        // Every payload but a delta starts from an empty struct: the
+        // converters append to containers. A payload that fails to parse
+        // leaves it empty.
+        const string data_reset = IsDeltaPush() ? "" : "    " + PayloadResetStatement("Data");
+
+        // A delta push merges through UnPack(), the wire parser would append
+        // to keyed arrays instead of updating them.
+        if (UsesWireParser() && !IsDeltaPush())
+        {
+            GenerateWireParser(printer, "F" + classname_ + "Struct");
+            if (HasWireTable())
+            {
+                GenerateWireTable(printer, "F" + classname_ + "Struct");
+            }
+            printer->Print(
+                "void U$classname$::Unpack(const uint8* Bytes, int32 Size) {\n", "classname", classname_);
+            printer->Print(shared_reset);
+            printer->Print(data_reset.c_str());
+            printer->Print(decompress);
+            printer->Print(
+                "    ::google::protobuf::io::CodedInputStream Input(Bytes, Size);\n"
+                "    if (!Data.MergeFromWire(&Input))\n"
+                "    {\n"
+                "$data_reset$"
+                "    }\n"
+                "}\n"
+                "\n"
+                , "data_reset", "    " + data_reset);
+        }
+        else
+        {
+            printer->Print(
+                "void U$classname$::Unpack(const uint8* Bytes, int32 Size) {\n", "classname", classname_);
+            printer->Print(shared_reset);
+            printer->Print(data_reset.c_str());
+            printer->Print(decompress);
+            printer->Indent();
+            GeneratePBMessageDeclaration(printer);
+            printer->Print(
+                "if (!pbMessage.ParseFromArray(Bytes, Size))\n"
+                "{\n"
+                "    return;\n"
+                "}\n\n"
+                "Data.UnPack(pbMessage);\n",
+                "classname", classname_);
+            printer->Outdent();
+            printer->Print(
+                "}\n"
+                "\n",
+                "classname", classname_);
+        }
+
+        if (options_.two_phase_unpack && !IsDeltaPush())
+        {
+            GenerateTwoPhaseUnpack(printer);
+        }
+
         printer->Print(
             "void U$classname$::Generic_GetDataStruct(void* OutData) {\n"
             "const UScriptStruct* StructType = F$classname$Struct::StaticStruct();\n"
             "if (StructType != nullptr)\n"
             "{\n"
-            "StructType->CopyScriptStruct(OutData, &Data);\n"
+            "StructType->CopyScriptStruct(OutData, $data$);\n"
             "}\n",
-            "classname", classname_);
+            "classname", classname_,
+            "data", "&Data");
 
         printer->Print(
             "}\n"
             "\n",
             "classname", classname_);
+
+        if (options_.shared_payload)
+        {
+            GenerateSharedData(printer);
+        }
+
+        if (HasStructReset())
+        {
+            GenerateReset(printer, "F" + classname_ + "Struct");
+        }
+        if (options_.object_pool)
+        {
+            if (!IsDeltaPush())
+            {
+                printer->Print(
+                    "void U$classname$::Reset()\n"
+                    "{\n",
+                    "classname", classname_);
+                printer->Print(shared_reset);
+                printer->Print(
+                    "    Data.Reset();\n"
+                    "}\n"
+                    "\n");
+                GeneratePoolMethods(printer);
+            }
+        }
     }
     else
     {
@@ -692,7 +2837,20 @@ void UEMessageGenerator::GenerateClassMethods(io::Printer* printer)
             "void F$classname$::FromPB(const $classname$& pbMessage) {\n",
             "classname", classname_);
         printer->Indent();
-        FromPBMessage(printer);
+        if (options_.table_driven_parsing && HasWireTable())
+        {
+            printer->Print(
+                "*this = F$classname$();\n"
+                "if (!ProtoUE::MergeFromMessage(pbMessage, *this))\n"
+                "{\n"
+                "    *this = F$classname$();\n"
+                "}\n",
+                "classname", classname_);
+        }
+        else
+        {
+            FromPBMessage(printer);
+        }
         printer->Outdent();
         printer->Print("}\n\n");
 
@@ -700,8 +2858,41 @@ void UEMessageGenerator::GenerateClassMethods(io::Printer* printer)
             "void F$classname$::ToPB($classname$& pbMessage) const {\n",
             "classname", classname_);
 
-        ToPBMessage(printer);
+        if (options_.table_driven_serialization && HasWireTable())
+        {
+            printer->Print(
+                "    if (!ProtoUE::ToMessage(*this, pbMessage))\n"
+                "    {\n"
+                "        pbMessage.Clear();\n"
+                "    }\n");
+        }
+        else
+        {
+            ToPBMessage(printer);
+        }
 
         printer->Print("}\n\n");
+
+        if (IsScalarOnlyMessage(descriptor_))
+        {
+            GenerateScalarOnlyArrays(printer);
+        }
+        if (UsesWireParser())
+        {
+            GenerateWireParser(printer, "F" + classname_);
+        }
+        if (UsesWireSerializer())
+        {
+            GenerateWireSize(printer, "F" + classname_);
+            GenerateWireSerializer(printer, "F" + classname_);
+        }
+        if (HasWireTable())
+        {
+            GenerateWireTable(printer, "F" + classname_);
+        }
+        if (HasStructReset())
+        {
+            GenerateReset(printer, "F" + classname_);
+        }
     }
 }
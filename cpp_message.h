@@ -48,17 +48,98 @@ public:
 	void GenerateClassMethods(io::Printer* printer);
 
 	void ToPBMessage_Map(io::Printer* printer, const FieldDescriptor *field);
-	void ToPBMessage_MapPair(io::Printer* printer, const FieldDescriptor *field, const std::string part);
+	void ToPBMessage_MapPair(io::Printer* printer, const FieldDescriptor *field,
+		const FieldDescriptor *key, const FieldDescriptor *value);
 	void ToPBMessage_Normal(io::Printer* printer, const FieldDescriptor *field);
 	void ToPBMessage_Repeated(io::Printer* printer, const FieldDescriptor *field);
 	void ToPBMessage(io::Printer* printer);
 
-	void FromPBMessage_Map(io::Printer* printer, const FieldDescriptor *field);
-	void FromPBMessage_MapPair(io::Printer* printer, const FieldDescriptor *field, const std::string part);
-	void FromPBMessage_Normal(io::Printer* printer, const FieldDescriptor *field);
-	void FromPBMessage_Repeated(io::Printer* printer, const FieldDescriptor *field);
+	// reuse_containers: replace destination contents instead of appending;
+	// options_.reuse_containers except for delta pushes, which upsert.
+	void FromPBMessage_Map(io::Printer* printer, const FieldDescriptor *field, bool reuse_containers);
+	void FromPBMessage_MapPair(io::Printer* printer, const FieldDescriptor *field,
+		const FieldDescriptor *key, const FieldDescriptor *value);
+	void FromPBMessage_Normal(io::Printer* printer, const FieldDescriptor *field, bool reuse_containers);
+	void FromPBMessage_Repeated(io::Printer* printer, const FieldDescriptor *field, bool reuse_containers);
 	void FromPBMessage(io::Printer* printer);
 
+	// oneofs: a case enum per oneof and a ProtoUE::TOneof member holding the
+	// set field; conversion switches on the protobuf x_case().
+	void GenerateOneofCaseEnums(io::Printer* printer);
+	void GenerateOneofMembers(io::Printer* printer);
+	void FromPBOneof(io::Printer* printer, const OneofDescriptor *oneof, bool delta);
+	void ToPBOneof(io::Printer* printer, const OneofDescriptor *oneof);
+
+	// dirty_tracking (*Req only): per-field dirty bits, set by the generated
+	// BlueprintSetters, gate which fields Pack() writes.
+	string DirtyBitCheck(const FieldDescriptor *field);
+	string DirtyBitMask(int bit);
+	string DirtySetterParam(const FieldDescriptor *field);
+	void GenerateDirtyTrackingDeclarations(io::Printer* printer);
+	void GenerateDirtyTrackingMethods(io::Printer* printer);
+
+	// delta_push (*Push only): UnPack() merges the fields present in the push
+	// into the existing Data, with keyed upserts and "_removed" deletions.
+	bool IsDeltaPush();
+	void FromPBDelta(io::Printer* printer);
+	void FromPBDelta_Keyed(io::Printer* printer, const FieldDescriptor *field, const FieldDescriptor *key);
+
+	// Declares the local "pbMessage" used by Pack()/Unpack(), either on the
+	// stack or on the thread's reusable arena.
+	void GeneratePBMessageDeclaration(io::Printer* printer);
+
+	// direct_serialization: ComputeWireSize()/SerializeWire() write the wire
+	// format straight from the UE members, in field number order like the
+	// .pb.cc serializer, so the output is byte-identical to ToPB + Serialize
+	// except for the order of map entries.
+	void GenerateWireSize(io::Printer* printer, const string& qualified_classname);
+	void GenerateWireSerializer(io::Printer* printer, const string& qualified_classname);
+	void WireSize_Field(io::Printer* printer, const FieldDescriptor *field);
+	void WireWrite_Field(io::Printer* printer, const FieldDescriptor *field);
+
+	// direct_parsing: MergeFromWire() decodes the wire format straight into
+	// the UE members, skipping unknown fields.
+	void GenerateWireParser(io::Printer* printer, const string& qualified_classname);
+	void WireRead_Field(io::Printer* printer, const FieldDescriptor *field);
+
+	// table_driven_parsing / table_driven_serialization: the wire methods
+	// interpret a constant WireTable() (ProtoUETable.h) instead of being
+	// unrolled per field, FromPB/ToPB go through the wire format.
+	bool UsesWireParser();
+	bool UsesWireSerializer();
+	bool HasWireTable();
+	void GenerateWireTable(io::Printer* printer, const string& qualified_classname);
+
+	// object_pool: Acquire()/Release() on the UObject classes through
+	// ProtoUE::TObjectPool, and Reset() on every generated type.
+	void GeneratePoolDeclarations(io::Printer* printer);
+	void GeneratePoolMethods(io::Printer* printer);
+	void GenerateReset(io::Printer* printer, const string& qualified_classname);
+
+	// Structs get the capacity-keeping Reset() with object_pool or
+	// reuse_containers.
+	bool HasStructReset();
+	// Statement that empties the payload struct target before a decode.
+	string PayloadResetStatement(const string& target);
+
+	// shared_payload: GetSharedData() on *Resp/*Push classes.
+	void GenerateSharedData(io::Printer* printer);
+
+	// batch_requests: AppendPayload() on *Req classes.
+	void GenerateAppendPayload(io::Printer* printer);
+
+	// compress: Pack() compresses payloads from the message's threshold on.
+	void GeneratePackBytes(io::Printer* printer, int threshold);
+
+	// two_phase_unpack: static ParseData() for worker threads and
+	// PublishData() for the game thread on *Resp/*Push classes.
+	void GenerateTwoPhaseUnpack(io::Printer* printer);
+
+
+	// Messages of only singular scalars (IsScalarOnlyMessage()): trivially
+	// copyable struct traits and FromPBArray()/ToPBArray() for repeated fields.
+	void GenerateScalarOnlyTraits(io::Printer* printer);
+	void GenerateScalarOnlyArrays(io::Printer* printer);
 
 	void Flatten(std::vector<UEMessageGenerator*>* list);
 	const Descriptor* descriptor_;
@@ -94,7 +94,7 @@ MessageFieldGenerator::~MessageFieldGenerator() {}
 void MessageFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
   printer->Print(variables_,
-	  "UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
+	  "$uproperty$\n"
 	  "F$type$ $name$;\n\n");
 }
 
@@ -901,8 +901,8 @@ RepeatedMessageFieldGenerator::~RepeatedMessageFieldGenerator() {}
 void RepeatedMessageFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
   printer->Print(variables_,
-	"UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
-    "TArray<F$type$> $name$;\n\n");
+	"$uproperty$\n"
+    "TArray<F$type$$allocator$> $name$;\n\n");
 }
 
 void RepeatedMessageFieldGenerator::
@@ -41,6 +41,9 @@ namespace protobuf {
 namespace compiler {
 namespace cpp {
 
+// Threshold used by a bare "compress" option or message annotation.
+const int kDefaultCompressThreshold = 1024;
+
 // Generator options (see generator.cc for a description of each):
 struct Options {
   Options()
@@ -50,7 +53,22 @@ struct Options {
         annotate_headers(false),
         enforce_lite(false),
         table_driven_parsing(false),
-        table_driven_serialization(false) {}
+        table_driven_serialization(false),
+        copy_free_conversion(false),
+        reuse_containers(false),
+        lazy_strings(false),
+        arena(false),
+        direct_serialization(false),
+        direct_parsing(false),
+        presence_aware(false),
+        dirty_tracking(false),
+        delta_push(false),
+        object_pool(false),
+        shared_payload(false),
+        switch_dispatch(false),
+        batch_requests(false),
+        compress_threshold(0),
+        two_phase_unpack(false) {}
 
   string dllexport_decl;
   bool safe_boundary_check;
@@ -60,6 +78,22 @@ struct Options {
   bool enforce_lite;
   bool table_driven_parsing;
   bool table_driven_serialization;
+  bool copy_free_conversion;
+  bool reuse_containers;
+  bool lazy_strings;
+  bool arena;
+  bool direct_serialization;
+  bool direct_parsing;
+  bool presence_aware;
+  bool dirty_tracking;
+  bool delta_push;
+  bool object_pool;
+  bool shared_payload;
+  bool switch_dispatch;
+  bool batch_requests;
+  // Payloads of at least this many bytes are compressed, 0 disables.
+  int compress_threshold;
+  bool two_phase_unpack;
   string annotation_pragma_name;
   string annotation_guard_name;
 };
@@ -111,7 +111,7 @@ PrimitiveFieldGenerator::~PrimitiveFieldGenerator() {}
 void PrimitiveFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
   printer->Print(variables_,
-	  "UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
+	  "$uproperty$\n"
 	  "$type$ $name$;\n");
 }
 
@@ -283,8 +283,8 @@ RepeatedPrimitiveFieldGenerator::~RepeatedPrimitiveFieldGenerator() {}
 void RepeatedPrimitiveFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
   printer->Print(variables_,
-	"UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
-    "TArray<$type$> $name$;\n\n");
+	"$uproperty$\n"
+    "TArray<$type$$allocator$> $name$;\n\n");
 }
 
 void RepeatedPrimitiveFieldGenerator::
@@ -101,8 +101,20 @@ GeneratePrivateMembers(io::Printer* printer) const {
   // pointer in-memory.
 
   printer->Print(variables_, 
-	  "UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
-	  "FString $name$;\n\n");
+	  "$uproperty$\n");
+  if (IsLazyStringField(descriptor_, options_)) {
+    // Keeps the UTF-8 bytes and converts on first Get().
+    printer->Print(variables_, "FProtoLazyString $name$;\n\n");
+  } else if (IsBytesViewField(descriptor_, options_)) {
+    // Points into the buffer Unpack() parsed, see the "view" annotation.
+    printer->Print(variables_, "TArrayView<const uint8> $name$;\n\n");
+  } else if (descriptor_->type() == FieldDescriptor::TYPE_BYTES) {
+    printer->Print(variables_, "TArray<uint8> $name$;\n\n");
+  } else if (IsNameStringField(descriptor_)) {
+    printer->Print(variables_, "FName $name$;\n\n");
+  } else {
+    printer->Print(variables_, "FString $name$;\n\n");
+  }
 }
 
 void StringFieldGenerator::
@@ -857,8 +869,14 @@ RepeatedStringFieldGenerator::~RepeatedStringFieldGenerator() {}
 void RepeatedStringFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
   printer->Print(variables_,
-	"UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Example, Meta = (ExposeOnSpawn = true))\n"
-    "TArray<FString> $name$;\n\n");
+	"$uproperty$\n");
+  if (descriptor_->type() == FieldDescriptor::TYPE_BYTES) {
+    printer->Print(variables_, "TArray<TArray<uint8>$allocator$> $name$;\n\n");
+  } else if (IsNameStringField(descriptor_)) {
+    printer->Print(variables_, "TArray<FName$allocator$> $name$;\n\n");
+  } else {
+    printer->Print(variables_, "TArray<FString$allocator$> $name$;\n\n");
+  }
 }
 
 void RepeatedStringFieldGenerator::